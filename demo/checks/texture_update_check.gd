@@ -0,0 +1,55 @@
+extends SceneTree
+
+# Checks that editing a texture's noise regenerates it through the progressive and
+# time-sliced paths instead of waiting for the next get_image(). Run from the demo project:
+#
+#   godot --headless --path demo -s res://checks/texture_update_check.gd
+#
+# Headless runs draw no frames, so only the first progressive pass (generated on the
+# calling thread) completes; time-sliced textures are checked to have started.
+
+var failures := 0
+
+func _initialize() -> void:
+	_run.call_deferred()
+
+func _run() -> void:
+	await _check_progressive()
+	await _check_time_sliced()
+	print("%d texture update checks failed" % failures)
+	quit(1 if failures > 0 else 0)
+
+func _make_texture() -> SimplexTexture:
+	var texture := SimplexTexture.new()
+	texture.width = 256
+	texture.height = 256
+	texture.generate_mipmaps = false
+	texture.noise = Simplex.new()
+	return texture
+
+func _expect(condition: bool, message: String) -> void:
+	if not condition:
+		failures += 1
+		printerr("FAIL ", message)
+
+func _check_progressive() -> void:
+	var texture := _make_texture()
+	texture.progressive = true
+	await process_frame
+
+	var strides: Array[int] = []
+	texture.changed.connect(func(): strides.append(texture.last_generation_stats["progressive_stride"]))
+	texture.noise.frequency *= 2.0
+	texture.noise.seed += 1    # a burst of edits still queues a single update
+	await process_frame
+	await process_frame
+	_expect(strides.count(8) == 1, "noise edit queued one progressive pass at stride 8, strides seen %s" % [strides])
+
+func _check_time_sliced() -> void:
+	var texture := _make_texture()
+	texture.time_slice_usec = 1000
+	await process_frame
+
+	texture.noise.frequency *= 2.0
+	await process_frame
+	_expect(texture.is_generation_pending(), "noise edit started a time-sliced generation")
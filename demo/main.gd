@@ -61,6 +61,14 @@ func generate_terrain():
 		fnoise = FastNoiseLite.new()
 		fnoise.frequency_scale = frequency
 	
+	# Plain Simplex terrain is built natively: heights, normals and indices in one call
+	if elevation_map == null and noise_type == 0:
+		mesh = ArrayMesh.new()
+		mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES,
+			noise.build_height_mesh(Vector2(size, size), Vector2i(subdivisions, subdivisions), amplitude))
+		terrain.mesh = mesh
+		return
+
 	# Update mesh properties
 	var plane = PlaneMesh.new()
 	plane.size = Vector2(size, size)
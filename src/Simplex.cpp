@@ -1,5 +1,8 @@
 #include "Simplex.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <vector>
 using namespace godot;
 
 void Simplex::_bind_methods()
@@ -10,15 +13,37 @@ void Simplex::_bind_methods()
     ClassDB::bind_method(D_METHOD("get_noise_2dv", "v"), &Simplex::get_noise_2dv);
     ClassDB::bind_method(D_METHOD("get_noise_3dv", "v"), &Simplex::get_noise_3dv);
 
+    // Bind batch methods
+    ClassDB::bind_method(D_METHOD("get_noise_2d_batch", "points"), &Simplex::get_noise_2d_batch);
+    ClassDB::bind_method(D_METHOD("get_noise_3d_batch", "points"), &Simplex::get_noise_3d_batch);
+    ClassDB::bind_method(D_METHOD("get_noise_grid_2d", "origin", "size", "step"),
+        &Simplex::get_noise_grid_2d, DEFVAL(Vector2(1, 1)));
+
     // Bind image generation methods
-    ClassDB::bind_method(D_METHOD("get_image", "width", "height", "invert", "in_3d_space", "normalize"), 
-        &Simplex::get_image, DEFVAL(false), DEFVAL(false), DEFVAL(true));
-    ClassDB::bind_method(D_METHOD("get_seamless_image", "width", "height", "invert", "in_3d_space", "skirt", "normalize"), 
-        &Simplex::get_seamless_image, DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true));
-    ClassDB::bind_method(D_METHOD("get_image_3d", "width", "height", "depth", "invert", "normalize"), 
-        &Simplex::get_image_3d, DEFVAL(false), DEFVAL(true));
-    ClassDB::bind_method(D_METHOD("get_seamless_image_3d", "width", "height", "depth", "invert", "skirt", "normalize"), 
-        &Simplex::get_seamless_image_3d, DEFVAL(false), DEFVAL(0.1), DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("get_image", "width", "height", "invert", "in_3d_space", "normalize", "format"), 
+        &Simplex::get_image, DEFVAL(false), DEFVAL(false), DEFVAL(true), DEFVAL(Image::FORMAT_L8));
+    ClassDB::bind_method(D_METHOD("get_seamless_image", "width", "height", "invert", "in_3d_space", "skirt", "normalize", "format"), 
+        &Simplex::get_seamless_image, DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(Image::FORMAT_L8));
+    ClassDB::bind_method(D_METHOD("get_image_3d", "width", "height", "depth", "invert", "normalize", "format"), 
+        &Simplex::get_image_3d, DEFVAL(false), DEFVAL(true), DEFVAL(Image::FORMAT_L8));
+    ClassDB::bind_method(D_METHOD("get_seamless_image_3d", "width", "height", "depth", "invert", "skirt", "normalize", "format"), 
+        &Simplex::get_seamless_image_3d, DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(Image::FORMAT_L8));
+    ClassDB::bind_method(D_METHOD("stream_image_3d", "callback", "width", "height", "depth", "invert", "seamless", "skirt", "normalize", "format"),
+        &Simplex::stream_image_3d, DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(Image::FORMAT_L8));
+    ClassDB::bind_method(D_METHOD("get_image_sliced", "callback", "width", "height", "invert", "in_3d_space", "seamless", "skirt", "normalize", "format", "budget_usec"),
+        &Simplex::get_image_sliced, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(Image::FORMAT_L8), DEFVAL(2000));
+    ClassDB::bind_method(D_METHOD("get_image_3d_sliced", "callback", "width", "height", "depth", "invert", "seamless", "skirt", "normalize", "format", "budget_usec"),
+        &Simplex::get_image_3d_sliced, DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(Image::FORMAT_L8), DEFVAL(2000));
+    ClassDB::bind_method(D_METHOD("write_volume", "file", "width", "height", "depth", "invert", "seamless", "skirt", "normalize", "format"),
+        &Simplex::write_volume, DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(Image::FORMAT_L8));
+    ClassDB::bind_method(D_METHOD("export_heightmap", "path", "width", "height", "format", "invert", "in_3d_space", "seamless", "skirt", "normalize", "tile_size"),
+        &Simplex::export_heightmap, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(256));
+    ClassDB::bind_method(D_METHOD("export_tile_pyramid", "directory", "width", "height", "format", "invert", "in_3d_space", "seamless", "skirt", "normalize", "tile_size"),
+        &Simplex::export_tile_pyramid, DEFVAL(false), DEFVAL(false), DEFVAL(false), DEFVAL(0.1), DEFVAL(true), DEFVAL(256));
+    ClassDB::bind_method(D_METHOD("build_height_mesh", "size", "subdivisions", "amplitude", "origin"),
+        &Simplex::build_height_mesh, DEFVAL(Vector2()));
+    ClassDB::bind_method(D_METHOD("get_height_map_data", "rect", "resolution", "amplitude"),
+        &Simplex::get_height_map_data, DEFVAL(1.0));
 
     // Bind setter and getter
     ClassDB::bind_method(D_METHOD("set_seed", "seed"), &Simplex::set_seed);
@@ -51,12 +76,17 @@ void Simplex::_bind_methods()
     ClassDB::bind_method(D_METHOD("get_domain_warp_lacunarity"), &Simplex::get_domain_warp_lacunarity);
     ClassDB::bind_method(D_METHOD("set_domain_warp_gain", "gain"), &Simplex::set_domain_warp_gain);
     ClassDB::bind_method(D_METHOD("get_domain_warp_gain"), &Simplex::get_domain_warp_gain);
+    ClassDB::bind_method(D_METHOD("set_remap_curve", "curve"), &Simplex::set_remap_curve);
+    ClassDB::bind_method(D_METHOD("get_remap_curve"), &Simplex::get_remap_curve);
+    ClassDB::bind_method(D_METHOD("_on_remap_curve_changed"), &Simplex::_on_remap_curve_changed);
 
     // Static Properties
     ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
     ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "frequency", 
         PROPERTY_HINT_RANGE, "0.0001,1,0.0001,exp"), 
         "set_frequency", "get_frequency");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "remap_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"),
+        "set_remap_curve", "get_remap_curve");
     
     // Enum
     BIND_ENUM_CONSTANT(FRACTAL_NONE);
@@ -67,6 +97,10 @@ void Simplex::_bind_methods()
     BIND_ENUM_CONSTANT(DOMAIN_WARP_FRACTAL_NONE);
     BIND_ENUM_CONSTANT(DOMAIN_WARP_FRACTAL_PROGRESSIVE);
     BIND_ENUM_CONSTANT(DOMAIN_WARP_FRACTAL_INDEPENDENT);
+    BIND_ENUM_CONSTANT(EXPORT_FORMAT_RAW_R16);
+    BIND_ENUM_CONSTANT(EXPORT_FORMAT_RAW_R32);
+    BIND_ENUM_CONSTANT(EXPORT_FORMAT_PNG16);
+    BIND_ENUM_CONSTANT(EXPORT_FORMAT_EXR);
 }
 
 void Simplex::_get_property_list(List<PropertyInfo> *p_list) const
@@ -77,6 +111,7 @@ void Simplex::_get_property_list(List<PropertyInfo> *p_list) const
     // Fractal type enum
     p_list->push_back(PropertyInfo(Variant::INT, "fractal_type", PROPERTY_HINT_ENUM, "None,FBM,Ridged,Ping-Pong"));
     
+    FractalType type = (FractalType)generator->mFractalType;
     if (type != FractalType::FRACTAL_NONE) {
         p_list->push_back(PropertyInfo(Variant::INT, "fractal_octaves"));
         p_list->push_back(PropertyInfo(Variant::FLOAT, "fractal_lacunarity"));
@@ -88,7 +123,7 @@ void Simplex::_get_property_list(List<PropertyInfo> *p_list) const
     p_list->push_back(PropertyInfo(Variant::NIL, "Domain Warp", PROPERTY_HINT_NONE, "domain_warp_", PROPERTY_USAGE_GROUP));
     p_list->push_back(PropertyInfo(Variant::BOOL, "domain_warp_enabled"));
 
-    if (domain_warp_enabled) {
+    if (generator->mDomainWarpEnabled) {
         p_list->push_back(PropertyInfo(Variant::INT, "domain_warp_type", PROPERTY_HINT_ENUM, "Simplex"));
         p_list->push_back(PropertyInfo(Variant::FLOAT, "domain_warp_amplitude"));
         p_list->push_back(PropertyInfo(Variant::FLOAT, "domain_warp_frequency", 
@@ -96,7 +131,7 @@ void Simplex::_get_property_list(List<PropertyInfo> *p_list) const
         p_list->push_back(PropertyInfo(Variant::INT, "domain_warp_fractal_type", 
             PROPERTY_HINT_ENUM, "None,Progressive,Independent"));
 
-        if (domain_warp_fractal_type != DomainWarpFractalType::DOMAIN_WARP_FRACTAL_NONE) {
+        if (generator->mDomainWarpFractalType != SimplexGenerator::DOMAIN_WARP_FRACTAL_NONE) {
             p_list->push_back(PropertyInfo(Variant::INT, "domain_warp_octaves"));
             p_list->push_back(PropertyInfo(Variant::FLOAT, "domain_warp_lacunarity"));
             p_list->push_back(PropertyInfo(Variant::FLOAT, "domain_warp_gain"));
@@ -237,19 +272,19 @@ bool Simplex::_set(const StringName &p_name, const Variant &p_value) {
 
 bool Simplex::_get(const StringName &p_name, Variant &r_ret) const {
     if (p_name == StringName("fractal_type")) {
-        r_ret = (int)type;
+        r_ret = (int)generator->mFractalType;
         return true;
     } else if (p_name == StringName("fractal_octaves")) {
-        r_ret = this->noise->mOctaves;
+        r_ret = this->generator->mNoise.mOctaves;
         return true;
     } else if (p_name == StringName("fractal_lacunarity")) {
-        r_ret = this->noise->mLacunarity;
+        r_ret = this->generator->mNoise.mLacunarity;
         return true;
     } else if (p_name == StringName("fractal_gain")) {
-        r_ret = this->noise->mPersistence;
+        r_ret = this->generator->mNoise.mPersistence;
         return true;
     } else if (p_name == StringName("fractal_ping_pong_strength")) {
-        r_ret = this->noise->mPingPongStrength;
+        r_ret = this->generator->mNoise.mPingPongStrength;
         return true;
     } else if (p_name == StringName("noise_preview")) {
         if (preview_cache.is_null()) {
@@ -259,28 +294,28 @@ bool Simplex::_get(const StringName &p_name, Variant &r_ret) const {
         return true;
     }
     else if (p_name == StringName("domain_warp_enabled")) {
-        r_ret = domain_warp_enabled;
+        r_ret = generator->mDomainWarpEnabled;
         return true;
     } else if (p_name == StringName("domain_warp_type")) {
         r_ret = (int)domain_warp_type;
         return true;
     } else if (p_name == StringName("domain_warp_amplitude")) {
-        r_ret = this->noise->mDomainWarpAmplitude;
+        r_ret = this->generator->mNoise.mDomainWarpAmplitude;
         return true;
     } else if (p_name == StringName("domain_warp_frequency")) {
-        r_ret = this->noise->mDomainWarpFrequency;
+        r_ret = this->generator->mNoise.mDomainWarpFrequency;
         return true;
     } else if (p_name == StringName("domain_warp_fractal_type")) {
-        r_ret = (int)domain_warp_fractal_type;
+        r_ret = (int)generator->mDomainWarpFractalType;
         return true;
     } else if (p_name == StringName("domain_warp_octaves")) {
-        r_ret = this->noise->mDomainWarpFractalOctaves;
+        r_ret = this->generator->mNoise.mDomainWarpFractalOctaves;
         return true;
     } else if (p_name == StringName("domain_warp_lacunarity")) {
-        r_ret = this->noise->mDomainWarpFractalLacunarity;
+        r_ret = this->generator->mNoise.mDomainWarpFractalLacunarity;
         return true;
     } else if (p_name == StringName("domain_warp_gain")) {
-        r_ret = this->noise->mDomainWarpFractalGain;
+        r_ret = this->generator->mNoise.mDomainWarpFractalGain;
         return true;
     }
     return false;
@@ -288,320 +323,237 @@ bool Simplex::_get(const StringName &p_name, Variant &r_ret) const {
 
 float Simplex::get_noise_1d(float p_x) const
 {
-    return this->noise->fractal(p_x, this->type == FRACTAL_NONE);
+    SimplexMonitors::add_samples(1, 1);
+    return this->generator->shape(this->generator->sample(p_x));
 }
 
 float Simplex::get_noise_2d(float p_x, float p_y) const
 {
-    if (domain_warp_enabled)
-        _apply_domain_warp_2d(p_x, p_y);
-
-    switch (this->type) {
-    case FRACTAL_RIDGED:
-        return this->noise->ridged(p_x, p_y);
-    case FRACTAL_PING_PONG:
-        return this->noise->pingpong(p_x, p_y);
-    default:
-        return this->noise->fractal(p_x, p_y, this->type == FRACTAL_NONE);
-    }
+    SimplexMonitors::add_samples(2, 1);
+    return this->generator->shape(this->generator->sample(p_x, p_y));
 }
 
 float Simplex::get_noise_2dv(const Vector2 &p_v) const
 {
-    real_t x = p_v.x, y = p_v.y;
-    if (domain_warp_enabled)
-        _apply_domain_warp_2d(x, y);
-    
+    SimplexMonitors::add_samples(2, 1);
+    return this->generator->shape(this->generator->sample((float)p_v.x, (float)p_v.y));
+}
+
+float Simplex::get_noise_3d(float p_x, float p_y, float p_z) const
+{
+    SimplexMonitors::add_samples(3, 1);
+    return this->generator->shape(this->generator->sample(p_x, p_y, p_z));
+}
 
-    switch (this->type) {
-    case FRACTAL_RIDGED:
-        return this->noise->ridged(x, y);
-    case FRACTAL_PING_PONG:
-        return this->noise->pingpong(x, y);
-    default:
-        return this->noise->fractal(x, y, this->type == FRACTAL_NONE);
+float Simplex::get_noise_3dv(const Vector3 &p_v) const
+{
+    SimplexMonitors::add_samples(3, 1);
+    return this->generator->shape(this->generator->sample((float)p_v.x, (float)p_v.y, (float)p_v.z));
+}
+
+PackedFloat32Array Simplex::get_noise_2d_batch(const PackedVector2Array &p_points) const
+{
+    PackedFloat32Array values;
+    values.resize(p_points.size());
+
+    SIMPLEX_TRACE_ZONE("Simplex::get_noise_2d_batch");
+    SIMPLEX_TRACE_VALUE(p_points.size());
+    SimplexMonitors::add_samples(2, p_points.size());
+    const Vector2 *points = p_points.ptr();
+    float *out = values.ptrw();
+    for (int64_t i = 0; i < p_points.size(); i++) {
+        out[i] = this->generator->shape(this->generator->sample((float)points[i].x, (float)points[i].y));
     }
-    
+    return values;
 }
 
-float Simplex::get_noise_3d(float p_x, float p_y, float p_z) const
+PackedFloat32Array Simplex::get_noise_3d_batch(const PackedVector3Array &p_points) const
 {
-    switch (this->type) {
-    case FRACTAL_RIDGED:
-        return this->noise->ridged(p_x, p_y, p_z);
-    case FRACTAL_PING_PONG:
-        return this->noise->pingpong(p_x, p_y, p_z);
-    default:
-        return this->noise->fractal(p_x, p_y, p_z), this->type == FRACTAL_NONE;
+    PackedFloat32Array values;
+    values.resize(p_points.size());
+
+    SIMPLEX_TRACE_ZONE("Simplex::get_noise_3d_batch");
+    SIMPLEX_TRACE_VALUE(p_points.size());
+    SimplexMonitors::add_samples(3, p_points.size());
+    const Vector3 *points = p_points.ptr();
+    float *out = values.ptrw();
+    for (int64_t i = 0; i < p_points.size(); i++) {
+        out[i] = this->generator->shape(this->generator->sample((float)points[i].x, (float)points[i].y, (float)points[i].z));
     }
+    return values;
 }
 
-float Simplex::get_noise_3dv(const Vector3 &p_v) const
+PackedFloat32Array Simplex::get_noise_grid_2d(const Vector2 &p_origin, const Vector2i &p_size, const Vector2 &p_step) const
+{
+    PackedFloat32Array values;
+    ERR_FAIL_COND_V_MSG(p_size.x <= 0 || p_size.y <= 0, values, "Grid size must be positive.");
+
+    values.resize((int64_t)p_size.x * p_size.y);
+    SIMPLEX_TRACE_ZONE("Simplex::get_noise_grid_2d");
+    SIMPLEX_TRACE_VALUE(values.size());
+    SimplexMonitors::add_samples(2, values.size());
+    this->generator->fillRegion2D(values.ptrw(), p_size.x, p_size.y, p_origin.x, p_origin.y,
+        p_step.x, p_step.y, 0, p_size.y);
+    return values;
+}
+
+bool Simplex::is_supported_image_format(Image::Format p_format)
 {
-    real_t x = p_v.x, y = p_v.y, z = p_v.z;
-
-    switch (this->type) {
-    case FRACTAL_RIDGED:
-        return this->noise->ridged(x, y, z);
-    case FRACTAL_PING_PONG:
-        return this->noise->pingpong(x, y, z);
-    default: // None and Fractal
-        return this->noise->fractal(x, y, z);
+    return p_format == Image::FORMAT_L8 || p_format == Image::FORMAT_RH || p_format == Image::FORMAT_RF;
+}
+
+int Simplex::image_format_pixel_size(Image::Format p_format)
+{
+    switch (p_format) {
+        case Image::FORMAT_RF:
+            return sizeof(float);
+        case Image::FORMAT_RH:
+            return sizeof(uint16_t);
+        default:
+            return 1;
     }
 }
 
-Ref<Image> Simplex::get_image(int32_t p_width, int32_t p_height, bool p_invert, bool p_in_3d_space, bool p_normalize) const
+void Simplex::encode_pixels(const float *p_values, int64_t p_count, bool p_invert, bool p_normalize, Image::Format p_format,
+    uint8_t *r_pixels, const SimplexCurveTable *p_curve)
 {
-    Ref<Image> image = Image::create(p_width, p_height, false, Image::FORMAT_L8);
-    
-    for (int y = 0; y < p_height; y++) {
-        for (int x = 0; x < p_width; x++) {
-            float n;
-            if (p_in_3d_space) {
-                // Use x,z plane with y=0
-                n = get_noise_3d((float)x, 0.0f, (float)y);
-            } else {
-                n = get_noise_2d((float)x, (float)y);
-            }
-            
-            if (p_normalize) {
-                n = (n + 1.0f) * 0.5f;
-            }
-            
-            if (p_invert) {
-                n = 1.0f - n;
-            }
-            
-            n = CLAMP(n, 0.0f, 1.0f);
-            uint8_t value = static_cast<uint8_t>(n * 255.0f);
-            image->set_pixel(x, y, Color(value / 255.0f, value / 255.0f, value / 255.0f));
-        }
+    switch (p_format) {
+        case Image::FORMAT_RF:
+            SimplexPost::toHeights(p_values, reinterpret_cast<float *>(r_pixels), p_count, p_normalize, p_invert, p_curve);
+            break;
+        case Image::FORMAT_RH:
+            SimplexPost::toHalfHeights(p_values, reinterpret_cast<uint16_t *>(r_pixels), p_count, p_normalize, p_invert, p_curve);
+            break;
+        default:
+            SimplexPost::toL8(p_values, r_pixels, p_count, p_normalize, p_invert, p_curve);
+            break;
     }
-    
-    return image;
 }
 
-Ref<Image> Simplex::get_seamless_image(int32_t p_width, int32_t p_height, bool p_invert, bool p_in_3d_space, float p_skirt, bool p_normalize) const
+Ref<Image> Simplex::create_image(const float *p_values, int32_t p_width, int32_t p_height, bool p_invert, bool p_normalize,
+    Image::Format p_format, const SimplexCurveTable *p_curve)
 {
-    Ref<Image> image = Image::create(p_width, p_height, false, Image::FORMAT_L8);
-    
-    float inv_width = 1.0f / (p_width - 1);
-    float inv_height = 1.0f / (p_height - 1);
-    float skirt = CLAMP(p_skirt, 0.0f, 0.5f);
-    
-    for (int y = 0; y < p_height; y++) {
-        float ny = y * inv_height;
-        
-        // Calculate vertical blend factor
-        float vy = 1.0f;
-        if (ny < skirt) {
-            // Top edge: blend with bottom
-            vy = ny / skirt;
-        } else if (ny > 1.0f - skirt) {
-            // Bottom edge: blend with top
-            vy = (1.0f - ny) / skirt;
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), Ref<Image>(), "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    int64_t count = (int64_t)p_width * p_height;
+    PackedByteArray data;
+    data.resize(count * image_format_pixel_size(p_format));
+    encode_pixels(p_values, count, p_invert, p_normalize, p_format, data.ptrw(), p_curve);
+    return Image::create_from_data(p_width, p_height, false, p_format, data);
+}
+
+void Simplex::fill_field_2d(const SimplexGenerator &p_generator, float *r_values, int32_t p_width, int32_t p_height,
+    bool p_seamless, bool p_in_3d_space, float p_skirt, SimplexScheduler::Priority p_priority)
+{
+    SIMPLEX_TRACE_ZONE("Simplex::fill_field_2d");
+    SIMPLEX_TRACE_VALUE((uint64_t)p_width * p_height);
+    SimplexMonitors::add_samples(p_in_3d_space ? 3 : 2, (uint64_t)p_width * p_height);
+
+    // Chunks of roughly 4k samples keep the workers balanced without much queue traffic
+    int grain = MAX(1, 4096 / p_width);
+    SimplexScheduler::parallel_for(p_height, p_priority, [&](int p_begin, int p_end) {
+        if (p_seamless) {
+            p_generator.fillSeamless2D(r_values, p_width, p_height, p_in_3d_space, p_skirt, p_begin, p_end);
+        } else {
+            p_generator.fillGrid2D(r_values, p_width, p_height, p_in_3d_space, p_begin, p_end);
         }
-        
-        for (int x = 0; x < p_width; x++) {
-            float nx = x * inv_width;
-            
-            // Calculate horizontal blend factor
-            float vx = 1.0f;
-            if (nx < skirt) {
-                // Left edge: blend with right
-                vx = nx / skirt;
-            } else if (nx > 1.0f - skirt) {
-                // Right edge: blend with left
-                vx = (1.0f - nx) / skirt;
-            }
-            
-            float n;
-            if (p_in_3d_space) {
-                // 3D seamless using torus
-                float angle_x = nx * Math_TAU;
-                float angle_y = ny * Math_TAU;
-                float px = Math::cos(angle_x);
-                float pz = Math::sin(angle_x);
-                float py = Math::cos(angle_y);
-                float pw = Math::sin(angle_y);
-                
-                float scale = 10.0f;
-                n = get_noise_3d(px * scale, py * scale, pz * scale) * 0.5f +
-                    get_noise_3d(py * scale, pz * scale, pw * scale) * 0.5f;
-            } else {
-                // Sample the four corners
-                float n_center = get_noise_2d(nx, ny);
-                float n_right = get_noise_2d(nx - 1.0f, ny);
-                float n_bottom = get_noise_2d(nx, ny - 1.0f);
-                float n_bottom_right = get_noise_2d(nx - 1.0f, ny - 1.0f);
-                
-                // Blend based on distance from edges
-                if (vx < 1.0f && vy < 1.0f) {
-                    // Corner: blend all four
-                    float n_horiz1 = Math::lerp(n_right, n_center, vx);
-                    float n_horiz2 = Math::lerp(n_bottom_right, n_bottom, vx);
-                    n = Math::lerp(n_horiz2, n_horiz1, vy);
-                } else if (vx < 1.0f) {
-                    // Horizontal blend only
-                    n = Math::lerp(n_right, n_center, vx);
-                } else if (vy < 1.0f) {
-                    // Vertical blend only
-                    n = Math::lerp(n_bottom, n_center, vy);
-                } else {
-                    // No blending
-                    n = n_center;
-                }
-            }
-            
-            if (p_normalize) {
-                n = (n + 1.0f) * 0.5f;
-            }
-            
-            if (p_invert) {
-                n = 1.0f - n;
-            }
-            
-            n = CLAMP(n, 0.0f, 1.0f);
-            uint8_t value = static_cast<uint8_t>(n * 255.0f);
-            image->set_pixel(x, y, Color(value / 255.0f, value / 255.0f, value / 255.0f));
+    }, grain);
+}
+
+void Simplex::fill_field_3d(const SimplexGenerator &p_generator, float *r_values, int32_t p_width, int32_t p_height,
+    int32_t p_depth, bool p_seamless, float p_skirt, SimplexScheduler::Priority p_priority)
+{
+    SIMPLEX_TRACE_ZONE("Simplex::fill_field_3d");
+    SIMPLEX_TRACE_VALUE((uint64_t)p_width * p_height * p_depth);
+    SimplexMonitors::add_samples(3, (uint64_t)p_width * p_height * p_depth);
+
+    SimplexScheduler::parallel_for(p_depth, p_priority, [&](int p_begin, int p_end) {
+        if (p_seamless) {
+            p_generator.fillSeamless3D(r_values, p_width, p_height, p_depth, p_skirt, p_begin, p_end);
+        } else {
+            p_generator.fillGrid3D(r_values, p_width, p_height, p_depth, p_begin, p_end);
         }
-    }
-    
-    return image;
+    });
 }
 
-TypedArray<Image> Simplex::get_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert, bool p_normalize) const
+Ref<Image> Simplex::get_image(int32_t p_width, int32_t p_height, bool p_invert, bool p_in_3d_space, bool p_normalize, Image::Format p_format) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0, Ref<Image>(), "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), Ref<Image>(), "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    SIMPLEX_TRACE_ZONE("Simplex::get_image");
+
+    std::vector<float> values((size_t)p_width * p_height);
+    fill_field_2d(*generator, values.data(), p_width, p_height, false, p_in_3d_space, 0.0f, SimplexScheduler::PRIORITY_INTERACTIVE);
+    return create_image(values.data(), p_width, p_height, p_invert, p_normalize, p_format);
+}
+
+Ref<Image> Simplex::get_seamless_image(int32_t p_width, int32_t p_height, bool p_invert, bool p_in_3d_space, float p_skirt, bool p_normalize, Image::Format p_format) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0, Ref<Image>(), "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), Ref<Image>(), "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    SIMPLEX_TRACE_ZONE("Simplex::get_seamless_image");
+
+    std::vector<float> values((size_t)p_width * p_height);
+    fill_field_2d(*generator, values.data(), p_width, p_height, true, p_in_3d_space, p_skirt, SimplexScheduler::PRIORITY_INTERACTIVE);
+    return create_image(values.data(), p_width, p_height, p_invert, p_normalize, p_format);
+}
+
+TypedArray<Image> Simplex::get_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert, bool p_normalize, Image::Format p_format) const
 {
     TypedArray<Image> images;
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0 || p_depth <= 0, images, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), images, "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
     images.resize(p_depth);
-    
+    SIMPLEX_TRACE_ZONE("Simplex::get_image_3d");
+
+    size_t slice_size = (size_t)p_width * p_height;
+    std::vector<float> values(slice_size * p_depth);
+    fill_field_3d(*generator, values.data(), p_width, p_height, p_depth, false, 0.0f, SimplexScheduler::PRIORITY_INTERACTIVE);
+
     for (int z = 0; z < p_depth; z++) {
-        Ref<Image> slice = Image::create(p_width, p_height, false, Image::FORMAT_L8);
-        
-        for (int y = 0; y < p_height; y++) {
-            for (int x = 0; x < p_width; x++) {
-                float n = get_noise_3d((float)x, (float)y, (float)z);
-                
-                if (p_normalize) {
-                    n = (n + 1.0f) * 0.5f;
-                }
-                
-                if (p_invert) {
-                    n = 1.0f - n;
-                }
-                
-                n = CLAMP(n, 0.0f, 1.0f);
-                uint8_t value = static_cast<uint8_t>(n * 255.0f);
-                slice->set_pixel(x, y, Color(value / 255.0f, value / 255.0f, value / 255.0f));
-            }
-        }
-        
-        images[z] = slice;
+        images[z] = create_image(values.data() + z * slice_size, p_width, p_height, p_invert, p_normalize, p_format);
     }
-    
     return images;
 }
 
-TypedArray<Image> Simplex::get_seamless_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert, float p_skirt, bool p_normalize) const
+TypedArray<Image> Simplex::get_seamless_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert, float p_skirt, bool p_normalize, Image::Format p_format) const
 {
     TypedArray<Image> images;
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0 || p_depth <= 0, images, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), images, "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
     images.resize(p_depth);
-    
-    float scale_x = 1.0f / (p_width - 1);
-    float scale_y = 1.0f / (p_height - 1);
-    float scale_z = 1.0f / (p_depth - 1);
-    float blend_start = p_skirt;
-    float blend_end = 1.0f - p_skirt;
-    
+    SIMPLEX_TRACE_ZONE("Simplex::get_seamless_image_3d");
+
+    size_t slice_size = (size_t)p_width * p_height;
+    std::vector<float> values(slice_size * p_depth);
+    fill_field_3d(*generator, values.data(), p_width, p_height, p_depth, true, p_skirt, SimplexScheduler::PRIORITY_INTERACTIVE);
+
     for (int z = 0; z < p_depth; z++) {
-        float nz = z * scale_z;
-        Ref<Image> slice = Image::create(p_width, p_height, false, Image::FORMAT_L8);
-        
-        for (int y = 0; y < p_height; y++) {
-            float ny = y * scale_y;
-            
-            for (int x = 0; x < p_width; x++) {
-                float nx = x * scale_x;
-                
-                // For 3D seamless, we need to sample 8 corners and blend
-                float n000 = get_noise_3d(nx, ny, nz);
-                float n100 = get_noise_3d(nx - 1.0f, ny, nz);
-                float n010 = get_noise_3d(nx, ny - 1.0f, nz);
-                float n110 = get_noise_3d(nx - 1.0f, ny - 1.0f, nz);
-                float n001 = get_noise_3d(nx, ny, nz - 1.0f);
-                float n101 = get_noise_3d(nx - 1.0f, ny, nz - 1.0f);
-                float n011 = get_noise_3d(nx, ny - 1.0f, nz - 1.0f);
-                float n111 = get_noise_3d(nx - 1.0f, ny - 1.0f, nz - 1.0f);
-                
-                // Calculate blend weights
-                float wx = 1.0f;
-                float wy = 1.0f;
-                float wz = 1.0f;
-                
-                if (nx < blend_start) {
-                    wx = Math::smoothstep(0.0f, blend_start, nx);
-                } else if (nx > blend_end) {
-                    wx = 1.0f - Math::smoothstep(blend_end, 1.0f, nx);
-                }
-                
-                if (ny < blend_start) {
-                    wy = Math::smoothstep(0.0f, blend_start, ny);
-                } else if (ny > blend_end) {
-                    wy = 1.0f - Math::smoothstep(blend_end, 1.0f, ny);
-                }
-                
-                if (nz < blend_start) {
-                    wz = Math::smoothstep(0.0f, blend_start, nz);
-                } else if (nz > blend_end) {
-                    wz = 1.0f - Math::smoothstep(blend_end, 1.0f, nz);
-                }
-                
-                // Trilinear interpolation
-                float n0 = Math::lerp(Math::lerp(n000, n100, wx), Math::lerp(n010, n110, wx), wy);
-                float n1 = Math::lerp(Math::lerp(n001, n101, wx), Math::lerp(n011, n111, wx), wy);
-                float n = Math::lerp(n0, n1, wz);
-                
-                if (p_normalize) {
-                    n = (n + 1.0f) * 0.5f;
-                }
-                
-                if (p_invert) {
-                    n = 1.0f - n;
-                }
-                
-                n = CLAMP(n, 0.0f, 1.0f);
-                uint8_t value = static_cast<uint8_t>(n * 255.0f);
-                slice->set_pixel(x, y, Color(value / 255.0f, value / 255.0f, value / 255.0f));
-            }
-        }
-        
-        images[z] = slice;
+        images[z] = create_image(values.data() + z * slice_size, p_width, p_height, p_invert, p_normalize, p_format);
     }
-    
     return images;
 }
 
 void Simplex::set_seed(int32_t seed)
 {
-    this->noise->mSeed = seed;
+    this->generator->mNoise.mSeed = seed;
     _update_preview();
     emit_changed();
 }
 
 int32_t Simplex::get_seed()
 {
-    return this->noise->mSeed;
+    return this->generator->mNoise.mSeed;
 }
 
 void Simplex::set_frequency(float frequency) {
     float freq = CLAMP(frequency, 0.0f, 1.0f);
-    this->noise->mFrequency = freq;
+    this->generator->mNoise.mFrequency = freq;
     _update_preview();
     emit_changed();
 }
 
 float Simplex::get_frequency() {
-    return this->noise->mFrequency;
+    return this->generator->mNoise.mFrequency;
 }
 
 void Simplex::_update_preview()
@@ -3,13 +3,19 @@
 #include <godot_cpp/classes/resource.hpp>
 #include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/curve.hpp>
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/global_constants.hpp>
 #include <godot_cpp/classes/ref.hpp>
 #include <godot_cpp/variant/typed_array.hpp>
 #include <type_traits>
 
-#include "lib/SimplexNoise.h"
+#include "lib/SimplexGenerator.h"
+#include "lib/SimplexExport.h"
+#include "SimplexScheduler.hpp"
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace godot
 {
@@ -42,19 +48,29 @@ namespace godot
             DOMAIN_WARP_FRACTAL_INDEPENDENT = 2,
         };
 
+        // File formats of export_heightmap / export_tile_pyramid, see lib/SimplexExport.h
+        enum ExportFormat {
+            EXPORT_FORMAT_RAW_R16 = SimplexExport::FORMAT_RAW_R16,
+            EXPORT_FORMAT_RAW_R32 = SimplexExport::FORMAT_RAW_R32,
+            EXPORT_FORMAT_PNG16 = SimplexExport::FORMAT_PNG16,
+            EXPORT_FORMAT_EXR = SimplexExport::FORMAT_EXR,
+        };
+
         float get_noise_1d(float p_x) const;
         float get_noise_2d(float p_x, float p_y) const;
         float get_noise_2dv(const Vector2 &p_v) const;
         float get_noise_3d(float p_x, float p_y, float p_z) const;
         float get_noise_3dv(const Vector3 &p_v) const;
-        Ref<Image> get_image(int32_t p_width, int32_t p_height, bool p_invert = false, bool p_in_3d_space = false, bool p_normalize = true) const;
-        Ref<Image> get_seamless_image(int32_t p_width, int32_t p_height, bool p_invert = false, bool p_in_3d_space = false, float p_skirt = 0.1, bool p_normalize = true) const;
-        TypedArray<Image> get_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert = false, bool p_normalize = true) const;
-        TypedArray<Image> get_seamless_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert = false, float p_skirt = 0.1, bool p_normalize = true) const;
-        Simplex() : domain_warp_enabled(false), domain_warp_type(DOMAIN_WARP_SIMPLEX),
-            domain_warp_fractal_type(DOMAIN_WARP_FRACTAL_PROGRESSIVE),
-            type(FRACTAL_NONE), noise(std::make_unique<SimplexNoise>()) {}
-        ~Simplex() {};
+        Ref<Image> get_image(int32_t p_width, int32_t p_height, bool p_invert = false, bool p_in_3d_space = false, bool p_normalize = true, Image::Format p_format = Image::FORMAT_L8) const;
+        PackedFloat32Array get_noise_2d_batch(const PackedVector2Array &p_points) const;
+        PackedFloat32Array get_noise_3d_batch(const PackedVector3Array &p_points) const;
+        PackedFloat32Array get_noise_grid_2d(const Vector2 &p_origin, const Vector2i &p_size, const Vector2 &p_step = Vector2(1, 1)) const;
+        Ref<Image> get_seamless_image(int32_t p_width, int32_t p_height, bool p_invert = false, bool p_in_3d_space = false, float p_skirt = 0.1, bool p_normalize = true, Image::Format p_format = Image::FORMAT_L8) const;
+        TypedArray<Image> get_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert = false, bool p_normalize = true, Image::Format p_format = Image::FORMAT_L8) const;
+        TypedArray<Image> get_seamless_image_3d(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert = false, float p_skirt = 0.1, bool p_normalize = true, Image::Format p_format = Image::FORMAT_L8) const;
+        Simplex() : domain_warp_type(DOMAIN_WARP_SIMPLEX),
+            generator(std::make_unique<SimplexGenerator>()) {}
+        ~Simplex();
 
         // Property getters setters
         void set_seed(int32_t seed);
@@ -89,12 +105,92 @@ namespace godot
         float get_domain_warp_lacunarity();
         void set_domain_warp_gain(float gain);
         float get_domain_warp_gain();
+
+        // Output shaping applied to every sample: the curve's x axis is the noise normalized
+        // to [0, 1], its y axis the shaped value in [0, 1] (scaled back to [-1, 1]). Images
+        // apply their normalize/invert afterwards, in the same order as the textures' curves.
+        void set_remap_curve(const Ref<Curve> &p_curve);
+        Ref<Curve> get_remap_curve() const;
+
+        // Bake a Curve for SimplexGenerator::mRemapCurve or SimplexPost; null without points
+        static std::shared_ptr<const SimplexCurveTable> bake_curve(const Ref<Curve> &p_curve);
+
+        // Native access to the Godot-independent core, see lib/SimplexGenerator.h.
+        // Copy it to snapshot the current parameters for use on another thread.
+        const SimplexGenerator &get_generator() const { return *generator; }
+
+        // Fill the raw field behind get_image/get_seamless_image (or the 3D variants) with rows
+        // (or slices) split across the SimplexScheduler workers.
+        static void fill_field_2d(const SimplexGenerator &p_generator, float *r_values, int32_t p_width, int32_t p_height,
+            bool p_seamless, bool p_in_3d_space, float p_skirt, SimplexScheduler::Priority p_priority);
+        static void fill_field_3d(const SimplexGenerator &p_generator, float *r_values, int32_t p_width, int32_t p_height,
+            int32_t p_depth, bool p_seamless, float p_skirt, SimplexScheduler::Priority p_priority);
+
+        // Image output of a raw field: FORMAT_L8, or FORMAT_RH / FORMAT_RF written straight from the
+        // floats for heightmaps that need more than 256 levels. Other formats are an error.
+        static bool is_supported_image_format(Image::Format p_format);
+        static Ref<Image> create_image(const float *p_values, int32_t p_width, int32_t p_height, bool p_invert, bool p_normalize,
+            Image::Format p_format, const SimplexCurveTable *p_curve = nullptr);
+        // The texel bytes behind create_image, for callers that write them somewhere else
+        static int image_format_pixel_size(Image::Format p_format);
+        static void encode_pixels(const float *p_values, int64_t p_count, bool p_invert, bool p_normalize, Image::Format p_format,
+            uint8_t *r_pixels, const SimplexCurveTable *p_curve = nullptr);
+
+        // Streaming volume generation: slices are produced a few at a time (one per worker) and
+        // handed over in order, so peak memory is a handful of slices instead of the volume.
+        // p_callback(z: int, slice: Image) runs on the calling thread; returning false stops the
+        // stream with ERR_SKIP. write_volume stores the raw texels (z-major, rows of p_width,
+        // little-endian for RH/RF) at the current position of p_file.
+        Error stream_image_3d(const Callable &p_callback, int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert = false,
+            bool p_seamless = false, float p_skirt = 0.1, bool p_normalize = true, Image::Format p_format = Image::FORMAT_L8) const;
+        Error write_volume(const Ref<FileAccess> &p_file, int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert = false,
+            bool p_seamless = false, float p_skirt = 0.1, bool p_normalize = true, Image::Format p_format = Image::FORMAT_L8) const;
+
+        // get_image / get_image_3d spread over frames for sizes that would stall one: bands of
+        // rows (or whole slices) are generated and encoded on the main thread until p_budget_usec
+        // is spent, then p_callback(image: Image) or p_callback(images: Array[Image]) is called in
+        // a later frame. The noise settings are snapshotted when the call is made. Without a
+        // SimplexScheduler (before SCENE initialization) the image is built before returning.
+        Error get_image_sliced(const Callable &p_callback, int32_t p_width, int32_t p_height, bool p_invert = false,
+            bool p_in_3d_space = false, bool p_seamless = false, float p_skirt = 0.1, bool p_normalize = true,
+            Image::Format p_format = Image::FORMAT_L8, int32_t p_budget_usec = 2000) const;
+        Error get_image_3d_sliced(const Callable &p_callback, int32_t p_width, int32_t p_height, int32_t p_depth,
+            bool p_invert = false, bool p_seamless = false, float p_skirt = 0.1, bool p_normalize = true,
+            Image::Format p_format = Image::FORMAT_L8, int32_t p_budget_usec = 2000) const;
+
+        // Heightmap export for images too large for get_image: p_tile_size tiles are generated
+        // in parallel and streamed to p_path, top to bottom, through FileAccess. The heights
+        // are the get_image values in [0, 1] (after normalize/invert), kept at 16 or 32 bits.
+        Error export_heightmap(const String &p_path, int32_t p_width, int32_t p_height, ExportFormat p_format,
+            bool p_invert = false, bool p_in_3d_space = false, bool p_seamless = false, float p_skirt = 0.1,
+            bool p_normalize = true, int32_t p_tile_size = 256) const;
+        // Same heights as a quadtree of p_tile_size tiles: <p_directory>/<level>/<x>_<y>.<ext>,
+        // level 0 at full resolution and each level above a 2x2 box-filtered half, up to a
+        // single tile. Parents are built from their children as soon as those are written.
+        Error export_tile_pyramid(const String &p_directory, int32_t p_width, int32_t p_height, ExportFormat p_format,
+            bool p_invert = false, bool p_in_3d_space = false, bool p_seamless = false, float p_skirt = 0.1,
+            bool p_normalize = true, int32_t p_tile_size = 256) const;
+
+        // Terrain surface for ArrayMesh.add_surface_from_arrays: a p_size plane centered on the
+        // origin, laid out like a PlaneMesh with the same subdivisions (p_subdivisions + 1 quads
+        // per side), with y = get_noise_2d(p_origin.x + x, p_origin.y + z) * p_amplitude.
+        // Normals and tangents come from the height grid, with one extra ring of samples so that
+        // chunks placed side by side at matching origins get continuous shading.
+        Array build_height_mesh(const Vector2 &p_size, const Vector2i &p_subdivisions, float p_amplitude,
+            const Vector2 &p_origin = Vector2()) const;
+        // HeightMapShape3D.map_data for p_rect (x, z in world units) sampled at p_resolution points
+        // (map_width, map_depth), rows along x: get_noise_2d * p_amplitude at every point, corners
+        // included. The shape is centered and spaced one unit apart, so place its CollisionShape3D
+        // at the center of p_rect and scale it by the spacing, p_rect.size / (p_resolution - 1);
+        // for a uniform scale, pass p_amplitude divided by that spacing.
+        PackedFloat32Array get_height_map_data(const Rect2 &p_rect, const Vector2i &p_resolution, float p_amplitude = 1.0) const;
     private:
-        std::unique_ptr<SimplexNoise> noise;
-        FractalType type;
+        // SimplexTerrainStreamer fills its reused chunk arrays with the mesh helpers below
+        friend class SimplexTerrainStreamer;
+
+        std::unique_ptr<SimplexGenerator> generator;
 
         // Domain Warp properties
-        bool domain_warp_enabled;
         DomainWarpType domain_warp_type;
         float domain_warp_amplitude;
         float domain_warp_frequency;
@@ -103,9 +199,35 @@ namespace godot
         float domain_warp_lacunarity;
         float domain_warp_gain;
 
-        // Helper methods
-        void _apply_domain_warp_2d(float& x, float& y) const;
-        void _apply_domain_warp_3d(float& x, float& y, float& z) const;
+        Ref<Curve> remap_curve;
+        void _on_remap_curve_changed();
+
+        struct TileExport;
+        static void _fill_heights(const TileExport &p_export, float *r_heights, int32_t p_x0, int32_t p_y0,
+            int32_t p_tile_width, int32_t p_tile_height);
+        static Error _export_pyramid_tile(const TileExport &p_export, int p_level, int p_x, int p_y, std::vector<float> &r_heights);
+
+        // The per-vertex half of build_height_mesh, for callers that keep their own arrays: rows
+        // [p_begin, p_end) of a p_columns * p_rows vertex grid, from raw noise values with a
+        // one-sample border ((p_columns + 2) * (p_rows + 2), first row and column at p_start - p_step).
+        // r_uvs may be null. _write_plane_indices writes the two triangles of each quad above rows
+        // [p_begin, p_end), p_begin at least 1.
+        static void _write_height_vertices(const float *p_heights, int32_t p_columns, int32_t p_rows, const Vector2 &p_start,
+            const Vector2 &p_step, float p_amplitude, Vector3 *r_vertices, Vector3 *r_normals, float *r_tangents,
+            Vector2 *r_uvs, int32_t p_begin, int32_t p_end);
+        static void _write_plane_indices(int32_t p_columns, int32_t *r_indices, int32_t p_begin, int32_t p_end);
+
+        // get_noise_2d at p_origin + (x, y) * p_step for every point of a p_width * p_height grid,
+        // rows split across the SimplexScheduler workers
+        void _fill_noise_grid(float *r_values, int32_t p_width, int32_t p_height, const Vector2 &p_origin,
+            const Vector2 &p_step) const;
+
+        struct SlicedImage;
+        static void _start_sliced_image(const std::shared_ptr<SlicedImage> &p_image);
+        static bool _step_sliced_image(SlicedImage &p_image);
+
+        Error _stream_slices(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_seamless, float p_skirt,
+            const std::function<Error(int, int, const float *)> &p_sink) const;
 
         Ref<ImageTexture> preview_cache; 
         void _update_preview(); // Helper to refresh the cache
@@ -114,4 +236,5 @@ namespace godot
 
 VARIANT_ENUM_CAST(Simplex::FractalType);
 VARIANT_ENUM_CAST(Simplex::DomainWarpType);
-VARIANT_ENUM_CAST(Simplex::DomainWarpFractalType);
\ No newline at end of file
+VARIANT_ENUM_CAST(Simplex::DomainWarpFractalType);
+VARIANT_ENUM_CAST(Simplex::ExportFormat);
\ No newline at end of file
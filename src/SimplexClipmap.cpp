@@ -0,0 +1,218 @@
+#include "SimplexClipmap.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
+
+#include <cstring>
+
+using namespace godot;
+
+SimplexClipmap::SimplexClipmap() :
+    level_count(6),
+    resolution(256),
+    in_3d_space(false),
+    last_update_samples(0) {
+    levels.resize(level_count);
+}
+
+SimplexClipmap::~SimplexClipmap() {
+    if (noise.is_valid()) {
+        noise->disconnect("changed", Callable(this, "_on_noise_changed"));
+    }
+}
+
+void SimplexClipmap::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_noise", "noise"), &SimplexClipmap::set_noise);
+    ClassDB::bind_method(D_METHOD("get_noise"), &SimplexClipmap::get_noise);
+    ClassDB::bind_method(D_METHOD("set_level_count", "count"), &SimplexClipmap::set_level_count);
+    ClassDB::bind_method(D_METHOD("get_level_count"), &SimplexClipmap::get_level_count);
+    ClassDB::bind_method(D_METHOD("set_resolution", "resolution"), &SimplexClipmap::set_resolution);
+    ClassDB::bind_method(D_METHOD("get_resolution"), &SimplexClipmap::get_resolution);
+    ClassDB::bind_method(D_METHOD("set_in_3d_space", "enabled"), &SimplexClipmap::set_in_3d_space);
+    ClassDB::bind_method(D_METHOD("get_in_3d_space"), &SimplexClipmap::get_in_3d_space);
+    ClassDB::bind_method(D_METHOD("update", "center"), &SimplexClipmap::update);
+    ClassDB::bind_method(D_METHOD("get_level_texture", "level"), &SimplexClipmap::get_level_texture);
+    ClassDB::bind_method(D_METHOD("get_level_heights", "level"), &SimplexClipmap::get_level_heights);
+    ClassDB::bind_method(D_METHOD("get_level_origin", "level"), &SimplexClipmap::get_level_origin);
+    ClassDB::bind_method(D_METHOD("get_level_spacing", "level"), &SimplexClipmap::get_level_spacing);
+    ClassDB::bind_method(D_METHOD("get_level_rect", "level"), &SimplexClipmap::get_level_rect);
+    ClassDB::bind_method(D_METHOD("get_last_update_samples"), &SimplexClipmap::get_last_update_samples);
+    ClassDB::bind_method(D_METHOD("_on_noise_changed"), &SimplexClipmap::_on_noise_changed);
+
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "noise", PROPERTY_HINT_RESOURCE_TYPE, "Simplex"), "set_noise", "get_noise");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "level_count", PROPERTY_HINT_RANGE, "1,16,1"), "set_level_count", "get_level_count");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "resolution", PROPERTY_HINT_RANGE, "8,4096,2"), "set_resolution", "get_resolution");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "in_3d_space"), "set_in_3d_space", "get_in_3d_space");
+}
+
+void SimplexClipmap::_on_noise_changed() {
+    _reset();
+}
+
+void SimplexClipmap::_reset() {
+    // The textures are kept, so materials using them stay bound; the next update() refills them
+    for (Level &level : levels) {
+        level.valid = false;
+    }
+}
+
+int64_t SimplexClipmap::_fill_level(Level &r_level, int p_spacing, const SimplexRect &p_rect) const {
+    int rect_width = p_rect.x1 - p_rect.x0;
+    int64_t count = (int64_t)rect_width * (p_rect.y1 - p_rect.y0);
+    if (count <= 0) {
+        return 0;
+    }
+    SimplexMonitors::add_samples(in_3d_space ? 3 : 2, count);
+    const SimplexGenerator &generator = noise->get_generator();
+    float *values = r_level.values.data();
+    SimplexScheduler::parallel_for(p_rect.y1 - p_rect.y0, SimplexScheduler::PRIORITY_INTERACTIVE, [&](int p_begin, int p_end) {
+        generator.fillWrapped2D(values, resolution, resolution, in_3d_space, p_rect.x0, p_rect.y0 + p_begin, p_rect.x1,
+            p_rect.y0 + p_end, p_spacing);
+    }, MAX(1, 4096 / rect_width));
+    return count;
+}
+
+void SimplexClipmap::_upload_level(Level &r_level) {
+    SIMPLEX_TRACE_ZONE("SimplexClipmap upload");
+    PackedByteArray data;
+    data.resize((int64_t)r_level.values.size() * sizeof(float));
+    memcpy(data.ptrw(), r_level.values.data(), data.size());
+    if (r_level.image.is_null()) {
+        r_level.image = Image::create_from_data(resolution, resolution, false, Image::FORMAT_RF, data);
+    } else {
+        r_level.image->set_data(resolution, resolution, false, Image::FORMAT_RF, data);
+    }
+    // update() keeps the RID when the size and format are unchanged
+    if (r_level.texture.is_null()) {
+        r_level.texture = ImageTexture::create_from_image(r_level.image);
+    } else if (r_level.texture->get_size() == Vector2(resolution, resolution)) {
+        r_level.texture->update(r_level.image);
+    } else {
+        r_level.texture->set_image(r_level.image);
+    }
+}
+
+void SimplexClipmap::update(const Vector2 &p_center) {
+    ERR_FAIL_COND_MSG(noise.is_null(), "SimplexClipmap needs a noise to update.");
+    SIMPLEX_TRACE_ZONE("SimplexClipmap::update");
+    last_update_samples = 0;
+    bool changed = false;
+    int half = resolution / 2;
+    for (int i = 0; i < (int)levels.size(); i++) {
+        Level &level = levels[i];
+        int spacing = 1 << i;
+        // The corner itself is snapped to every other sample of the level, so the window starts
+        // on a sample of the next coarser level whatever the resolution, keeping the rings nested
+        Vector2i origin((int)Math::floor((p_center.x / spacing - half) / 2.0f) * 2,
+            (int)Math::floor((p_center.y / spacing - half) / 2.0f) * 2);
+        if (level.valid && level.origin == origin) {
+            continue;
+        }
+
+        SimplexRect rects[2];
+        int count = 1;
+        if (level.valid) {
+            count = SimplexGenerator::scrollExposed(resolution, resolution, level.origin.x, level.origin.y, origin.x,
+                origin.y, rects);
+        } else {
+            level.values.resize((size_t)resolution * resolution);
+            rects[0] = SimplexRect{ origin.x, origin.y, origin.x + resolution, origin.y + resolution };
+        }
+        for (int r = 0; r < count; r++) {
+            last_update_samples += _fill_level(level, spacing, rects[r]);
+        }
+        level.origin = origin;
+        level.valid = true;
+        _upload_level(level);
+        changed = true;
+    }
+    SIMPLEX_TRACE_VALUE(last_update_samples);
+    if (changed) {
+        emit_changed();
+    }
+}
+
+Ref<ImageTexture> SimplexClipmap::get_level_texture(int p_level) const {
+    ERR_FAIL_INDEX_V(p_level, (int)levels.size(), Ref<ImageTexture>());
+    return levels[p_level].texture;
+}
+
+PackedFloat32Array SimplexClipmap::get_level_heights(int p_level) const {
+    PackedFloat32Array heights;
+    ERR_FAIL_INDEX_V(p_level, (int)levels.size(), heights);
+    const Level &level = levels[p_level];
+    if (level.valid) {
+        heights.resize((int64_t)level.values.size());
+        memcpy(heights.ptrw(), level.values.data(), level.values.size() * sizeof(float));
+    }
+    return heights;
+}
+
+Vector2i SimplexClipmap::get_level_origin(int p_level) const {
+    ERR_FAIL_INDEX_V(p_level, (int)levels.size(), Vector2i());
+    return levels[p_level].origin;
+}
+
+int SimplexClipmap::get_level_spacing(int p_level) const {
+    ERR_FAIL_INDEX_V(p_level, (int)levels.size(), 0);
+    return 1 << p_level;
+}
+
+Rect2i SimplexClipmap::get_level_rect(int p_level) const {
+    ERR_FAIL_INDEX_V(p_level, (int)levels.size(), Rect2i());
+    int spacing = 1 << p_level;
+    return Rect2i(levels[p_level].origin * spacing, Vector2i(resolution, resolution) * spacing);
+}
+
+int64_t SimplexClipmap::get_last_update_samples() const {
+    return last_update_samples;
+}
+
+void SimplexClipmap::set_noise(const Ref<Simplex> &p_noise) {
+    if (noise == p_noise) {
+        return;
+    }
+    if (noise.is_valid()) {
+        noise->disconnect("changed", Callable(this, "_on_noise_changed"));
+    }
+    noise = p_noise;
+    if (noise.is_valid()) {
+        noise->connect("changed", Callable(this, "_on_noise_changed"));
+    }
+    _reset();
+}
+
+Ref<Simplex> SimplexClipmap::get_noise() const {
+    return noise;
+}
+
+void SimplexClipmap::set_level_count(int p_count) {
+    level_count = CLAMP(p_count, 1, 16);
+    levels.resize(level_count);
+}
+
+int SimplexClipmap::get_level_count() const {
+    return level_count;
+}
+
+void SimplexClipmap::set_resolution(int p_resolution) {
+    p_resolution = CLAMP(p_resolution, 8, 4096) & ~1;
+    if (resolution != p_resolution) {
+        resolution = p_resolution;
+        _reset();
+    }
+}
+
+int SimplexClipmap::get_resolution() const {
+    return resolution;
+}
+
+void SimplexClipmap::set_in_3d_space(bool p_enabled) {
+    if (in_3d_space != p_enabled) {
+        in_3d_space = p_enabled;
+        _reset();
+    }
+}
+
+bool SimplexClipmap::get_in_3d_space() const {
+    return in_3d_space;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/resource.hpp>
+#include "Simplex.hpp"
+
+#include <vector>
+
+namespace godot {
+
+// Heightfield clipmap: level_count nested square windows of resolution * resolution noise
+// samples centered on a point, level L spaced 1 << L apart (in level 0 samples, i.e. the pixels
+// of get_image). Each level is a wrapped buffer like SimplexTexture with an offset: sample (i, j)
+// of level L, the noise at (i, j) * (1 << L), lives at texel (i mod resolution, j mod resolution)
+// of get_level_texture(L), so moving the center only samples the rows and columns that enter a
+// window. Shaders read it with texture repeat enabled, at UV (i + 0.5, j + 0.5) / resolution.
+class SimplexClipmap : public Resource {
+    GDCLASS(SimplexClipmap, Resource)
+
+    struct Level {
+        std::vector<float> values;
+        Vector2i origin;    // first sample of the window, in samples of this level
+        bool valid = false;
+        Ref<Image> image;
+        Ref<ImageTexture> texture;
+    };
+
+    Ref<Simplex> noise;
+    int level_count;
+    int resolution;
+    bool in_3d_space;
+
+    std::vector<Level> levels;
+    int64_t last_update_samples;
+
+    void _on_noise_changed();
+    void _reset();
+    int64_t _fill_level(Level &r_level, int p_spacing, const SimplexRect &p_rect) const;
+    void _upload_level(Level &r_level);
+
+protected:
+    static void _bind_methods();
+
+public:
+    SimplexClipmap();
+    ~SimplexClipmap();
+
+    void set_noise(const Ref<Simplex> &p_noise);
+    Ref<Simplex> get_noise() const;
+
+    void set_level_count(int p_count);
+    int get_level_count() const;
+
+    // Samples per window side, even so that the window stays centered on update()'s p_center
+    void set_resolution(int p_resolution);
+    int get_resolution() const;
+
+    // Sample the x, z plane of the 3D noise instead of the 2D noise
+    void set_in_3d_space(bool p_enabled);
+    bool get_in_3d_space() const;
+
+    // Move every window to p_center (in level 0 samples) and refresh what entered them.
+    // Call it as the camera moves; levels whose window did not move are left alone.
+    void update(const Vector2 &p_center);
+
+    // FORMAT_RF, the raw noise values in [-1, 1]; null before the first update()
+    Ref<ImageTexture> get_level_texture(int p_level) const;
+    // The wrapped values behind get_level_texture, rows of resolution
+    PackedFloat32Array get_level_heights(int p_level) const;
+    Vector2i get_level_origin(int p_level) const;
+    int get_level_spacing(int p_level) const;
+    // Area covered by the level, in level 0 samples
+    Rect2i get_level_rect(int p_level) const;
+
+    // Noise samples taken by the last update(), resolution^2 per level at most
+    int64_t get_last_update_samples() const;
+};
+
+} // namespace godot
@@ -4,56 +4,56 @@ using namespace godot;
 
 void Simplex::set_lacunarity(float lacunarity)
 {
-    this->noise->mLacunarity = lacunarity;
+    this->generator->mNoise.mLacunarity = lacunarity;
     _update_preview();
     emit_changed();
 }
 
 float Simplex::get_lacunarity()
 {
-    return this->noise->mLacunarity;
+    return this->generator->mNoise.mLacunarity;
 }
 
 void Simplex::set_gain(float gain)
 {
-    this->noise->mPersistence = gain;
+    this->generator->mNoise.mPersistence = gain;
     _update_preview();
     emit_changed();
 }
 
 float Simplex::get_gain()
 {
-    return this->noise->mPersistence;
+    return this->generator->mNoise.mPersistence;
 }
 
 void Simplex::set_ping_pong_strength(float ping_pong_strength)
 {
-    this->noise->mPingPongStrength = ping_pong_strength;
+    this->generator->mNoise.mPingPongStrength = ping_pong_strength;
     _update_preview();
     emit_changed();
 }
 
 float Simplex::get_ping_pong_strength()
 {
-    return this->noise->mPingPongStrength;
+    return this->generator->mNoise.mPingPongStrength;
 }
 
 void Simplex::set_octaves(uint16_t octaves)
 {
-    this->noise->mOctaves = octaves;
+    this->generator->mNoise.mOctaves = octaves;
     _update_preview();
     emit_changed();
 }
 
 uint16_t Simplex::get_octaves()
 {
-    return this->noise->mOctaves;
+    return this->generator->mNoise.mOctaves;
 }
 
 void Simplex::set_fractal_type(FractalType fractal_type)
 {
-    if (this->type != fractal_type) {
-        this->type = fractal_type;
+    if (get_fractal_type() != fractal_type) {
+        this->generator->mFractalType = (SimplexGenerator::FractalType)fractal_type;
         _update_preview();
         notify_property_list_changed();
         emit_changed();
@@ -63,5 +63,5 @@ void Simplex::set_fractal_type(FractalType fractal_type)
 
 Simplex::FractalType Simplex::get_fractal_type()
 {
-    return this->type;
+    return (FractalType)this->generator->mFractalType;
 }
\ No newline at end of file
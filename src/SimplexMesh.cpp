@@ -0,0 +1,150 @@
+#include "Simplex.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
+#include <godot_cpp/classes/mesh.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace godot;
+
+void Simplex::_fill_noise_grid(float *r_values, int32_t p_width, int32_t p_height, const Vector2 &p_origin,
+    const Vector2 &p_step) const
+{
+    SimplexMonitors::add_samples(2, (uint64_t)p_width * p_height);
+    const SimplexGenerator &noise = *generator;
+    SimplexScheduler::parallel_for(p_height, SimplexScheduler::PRIORITY_INTERACTIVE, [&](int p_begin, int p_end) {
+        noise.fillRegion2D(r_values, p_width, p_height, p_origin.x, p_origin.y, p_step.x, p_step.y, p_begin, p_end);
+    }, MAX(1, 4096 / p_width));
+}
+
+void Simplex::_write_height_vertices(const float *p_heights, int32_t p_columns, int32_t p_rows, const Vector2 &p_start,
+    const Vector2 &p_step, float p_amplitude, Vector3 *r_vertices, Vector3 *r_normals, float *r_tangents, Vector2 *r_uvs,
+    int32_t p_begin, int32_t p_end)
+{
+    const int grid_width = p_columns + 2;
+    const float slope_x = p_amplitude / (2.0f * p_step.x);
+    const float slope_z = p_amplitude / (2.0f * p_step.y);
+    for (int z = p_begin; z < p_end; z++) {
+        const float *above = p_heights + (size_t)z * grid_width + 1;
+        const float *row = above + grid_width;
+        const float *below = row + grid_width;
+        float v = (float)z / (p_rows - 1);
+        for (int x = 0; x < p_columns; x++) {
+            int i = z * p_columns + x;
+            float dx = (row[x + 1] - row[x - 1]) * slope_x;
+            float dz = (below[x] - above[x]) * slope_z;
+            r_vertices[i] = Vector3(p_start.x + x * p_step.x, row[x] * p_amplitude, p_start.y + z * p_step.y);
+            r_normals[i] = Vector3(-dx, 1.0f, -dz).normalized();
+            // Along +x (and +u) over the surface, like PlaneMesh's (1, 0, 0) tangent
+            float tangent_length = std::sqrt(1.0f + dx * dx);
+            r_tangents[i * 4 + 0] = 1.0f / tangent_length;
+            r_tangents[i * 4 + 1] = dx / tangent_length;
+            r_tangents[i * 4 + 2] = 0.0f;
+            r_tangents[i * 4 + 3] = 1.0f;
+            if (r_uvs != nullptr) {
+                r_uvs[i] = Vector2((float)x / (p_columns - 1), v);
+            }
+        }
+    }
+}
+
+void Simplex::_write_plane_indices(int32_t p_columns, int32_t *r_indices, int32_t p_begin, int32_t p_end)
+{
+    // Same winding as PlaneMesh: front faces point up
+    for (int z = p_begin; z < p_end; z++) {
+        int32_t *quad = r_indices + (size_t)(z - 1) * (p_columns - 1) * 6;
+        int32_t previous = (z - 1) * p_columns;
+        int32_t current = z * p_columns;
+        for (int x = 1; x < p_columns; x++) {
+            *quad++ = previous + x - 1;
+            *quad++ = previous + x;
+            *quad++ = current + x - 1;
+            *quad++ = previous + x;
+            *quad++ = current + x;
+            *quad++ = current + x - 1;
+        }
+    }
+}
+
+Array Simplex::build_height_mesh(const Vector2 &p_size, const Vector2i &p_subdivisions, float p_amplitude,
+    const Vector2 &p_origin) const
+{
+    Array arrays;
+    ERR_FAIL_COND_V_MSG(p_size.x <= 0 || p_size.y <= 0, arrays, "Mesh size must be positive.");
+    ERR_FAIL_COND_V_MSG(p_subdivisions.x < 0 || p_subdivisions.y < 0, arrays, "Subdivisions must not be negative.");
+    ERR_FAIL_COND_V_MSG((int64_t)(p_subdivisions.x + 2) * (p_subdivisions.y + 2) > INT32_MAX / 6, arrays,
+        "Too many subdivisions for 32-bit indices.");
+    SIMPLEX_TRACE_ZONE("Simplex::build_height_mesh");
+
+    const int columns = p_subdivisions.x + 2;
+    const int rows = p_subdivisions.y + 2;
+    const Vector2 step(p_size.x / (columns - 1), p_size.y / (rows - 1));
+    const Vector2 start = p_size * -0.5f;
+    SIMPLEX_TRACE_VALUE((uint64_t)columns * rows);
+
+    // Heights with a one-sample border, so every vertex gets central differences
+    const int grid_width = columns + 2;
+    std::vector<float> heights((size_t)grid_width * (rows + 2));
+    _fill_noise_grid(heights.data(), grid_width, rows + 2, p_origin + start - step, step);
+
+    PackedVector3Array vertices;
+    PackedVector3Array normals;
+    PackedFloat32Array tangents;
+    PackedVector2Array uvs;
+    PackedInt32Array indices;
+    vertices.resize((int64_t)columns * rows);
+    normals.resize(vertices.size());
+    tangents.resize(vertices.size() * 4);
+    uvs.resize(vertices.size());
+    indices.resize((int64_t)(columns - 1) * (rows - 1) * 6);
+    // Copy-on-write pointers are taken once, on this thread
+    Vector3 *vertex_out = vertices.ptrw();
+    Vector3 *normal_out = normals.ptrw();
+    float *tangent_out = tangents.ptrw();
+    Vector2 *uv_out = uvs.ptrw();
+    int32_t *index_out = indices.ptrw();
+
+    SimplexScheduler::parallel_for(rows, SimplexScheduler::PRIORITY_INTERACTIVE, [&](int p_begin, int p_end) {
+        _write_height_vertices(heights.data(), columns, rows, start, step, p_amplitude, vertex_out, normal_out, tangent_out,
+            uv_out, p_begin, p_end);
+        _write_plane_indices(columns, index_out, MAX(1, p_begin), p_end);
+    }, MAX(1, 2048 / columns));
+
+    arrays.resize(Mesh::ARRAY_MAX);
+    arrays[Mesh::ARRAY_VERTEX] = vertices;
+    arrays[Mesh::ARRAY_NORMAL] = normals;
+    arrays[Mesh::ARRAY_TANGENT] = tangents;
+    arrays[Mesh::ARRAY_TEX_UV] = uvs;
+    arrays[Mesh::ARRAY_INDEX] = indices;
+    return arrays;
+}
+
+PackedFloat32Array Simplex::get_height_map_data(const Rect2 &p_rect, const Vector2i &p_resolution, float p_amplitude) const
+{
+    PackedFloat32Array heights;
+    ERR_FAIL_COND_V_MSG(p_resolution.x < 2 || p_resolution.y < 2, heights, "HeightMapShape3D needs at least 2x2 points.");
+    ERR_FAIL_COND_V_MSG(p_rect.size.x <= 0 || p_rect.size.y <= 0, heights, "Rect size must be positive.");
+    SIMPLEX_TRACE_ZONE("Simplex::get_height_map_data");
+
+    const int width = p_resolution.x;
+    const int depth = p_resolution.y;
+    const Vector2 step(p_rect.size.x / (width - 1), p_rect.size.y / (depth - 1));
+    heights.resize((int64_t)width * depth);
+    SIMPLEX_TRACE_VALUE(heights.size());
+    SimplexMonitors::add_samples(2, heights.size());
+
+    float *out = heights.ptrw();
+    const SimplexGenerator &noise = *generator;
+    SimplexScheduler::parallel_for(depth, SimplexScheduler::PRIORITY_INTERACTIVE, [&](int p_begin, int p_end) {
+        noise.fillRegion2D(out, width, depth, p_rect.position.x, p_rect.position.y, step.x, step.y, p_begin, p_end);
+        if (p_amplitude != 1.0f) {
+            float *rows = out + (size_t)p_begin * width;
+            size_t count = (size_t)(p_end - p_begin) * width;
+            for (size_t i = 0; i < count; i++) {
+                rows[i] *= p_amplitude;
+            }
+        }
+    }, MAX(1, 4096 / width));
+    return heights;
+}
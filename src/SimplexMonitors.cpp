@@ -0,0 +1,175 @@
+#include "SimplexMonitors.hpp"
+#include "SimplexScheduler.hpp"
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+using namespace godot;
+
+SimplexMonitors *SimplexMonitors::singleton = nullptr;
+
+std::atomic<uint64_t> SimplexMonitors::samples[3];
+std::atomic<uint64_t> SimplexMonitors::regenerations(0);
+std::atomic<uint64_t> SimplexMonitors::generations(0);
+std::atomic<uint64_t> SimplexMonitors::generation_usec_total(0);
+std::atomic<uint64_t> SimplexMonitors::last_generation_usec(0);
+std::atomic<uint64_t> SimplexMonitors::cache_hits[CACHE_MAX];
+std::atomic<uint64_t> SimplexMonitors::cache_misses[CACHE_MAX];
+
+static String _samples_monitor_name(int p_dimension)
+{
+    return String("Simplex/Samples ") + String::num_int64(p_dimension) + "D per second";
+}
+
+void SimplexMonitors::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("get_samples_per_second", "dimension"), &SimplexMonitors::get_samples_per_second);
+    ClassDB::bind_method(D_METHOD("get_regenerations_per_frame"), &SimplexMonitors::get_regenerations_per_frame);
+    ClassDB::bind_method(D_METHOD("get_last_generation_usec"), &SimplexMonitors::get_last_generation_usec);
+    ClassDB::bind_method(D_METHOD("get_average_generation_usec"), &SimplexMonitors::get_average_generation_usec);
+    ClassDB::bind_method(D_METHOD("get_queued_jobs"), &SimplexMonitors::get_queued_jobs);
+    ClassDB::bind_method(D_METHOD("get_in_flight_jobs"), &SimplexMonitors::get_in_flight_jobs);
+    ClassDB::bind_method(D_METHOD("get_texture_cache_hit_rate"), &SimplexMonitors::get_texture_cache_hit_rate);
+    ClassDB::bind_method(D_METHOD("get_field_cache_hit_rate"), &SimplexMonitors::get_field_cache_hit_rate);
+}
+
+void SimplexMonitors::add_generation(uint64_t p_usec)
+{
+    generations.fetch_add(1, std::memory_order_relaxed);
+    generation_usec_total.fetch_add(p_usec, std::memory_order_relaxed);
+    last_generation_usec.store(p_usec, std::memory_order_relaxed);
+}
+
+void SimplexMonitors::register_monitors()
+{
+    singleton = memnew(SimplexMonitors);
+    Performance *performance = Performance::get_singleton();
+
+    for (int dimension = 1; dimension <= 3; dimension++) {
+        Array args;
+        args.push_back(dimension);
+        performance->add_custom_monitor(_samples_monitor_name(dimension),
+            Callable(singleton, "get_samples_per_second"), args);
+    }
+    performance->add_custom_monitor("Simplex/Texture regenerations per frame", Callable(singleton, "get_regenerations_per_frame"));
+    performance->add_custom_monitor("Simplex/Last generation (usec)", Callable(singleton, "get_last_generation_usec"));
+    performance->add_custom_monitor("Simplex/Average generation (usec)", Callable(singleton, "get_average_generation_usec"));
+    performance->add_custom_monitor("Simplex/Queued jobs", Callable(singleton, "get_queued_jobs"));
+    performance->add_custom_monitor("Simplex/In-flight jobs", Callable(singleton, "get_in_flight_jobs"));
+    performance->add_custom_monitor("Simplex/Texture cache hit rate", Callable(singleton, "get_texture_cache_hit_rate"));
+    performance->add_custom_monitor("Simplex/Field cache hit rate", Callable(singleton, "get_field_cache_hit_rate"));
+}
+
+void SimplexMonitors::unregister_monitors()
+{
+    if (singleton == nullptr) {
+        return;
+    }
+    Performance *performance = Performance::get_singleton();
+    for (int dimension = 1; dimension <= 3; dimension++) {
+        performance->remove_custom_monitor(_samples_monitor_name(dimension));
+    }
+    performance->remove_custom_monitor("Simplex/Texture regenerations per frame");
+    performance->remove_custom_monitor("Simplex/Last generation (usec)");
+    performance->remove_custom_monitor("Simplex/Average generation (usec)");
+    performance->remove_custom_monitor("Simplex/Queued jobs");
+    performance->remove_custom_monitor("Simplex/In-flight jobs");
+    performance->remove_custom_monitor("Simplex/Texture cache hit rate");
+    performance->remove_custom_monitor("Simplex/Field cache hit rate");
+
+    memdelete(singleton);
+    singleton = nullptr;
+}
+
+void SimplexMonitors::update_rates()
+{
+    if (singleton == nullptr) {
+        return;
+    }
+    uint64_t now = Time::get_singleton()->get_ticks_usec();
+    uint64_t frame = (uint64_t)Engine::get_singleton()->get_frames_drawn();
+    uint64_t counts[3];
+    for (int i = 0; i < 3; i++) {
+        counts[i] = samples[i].load(std::memory_order_relaxed);
+    }
+    uint64_t regeneration_count = regenerations.load(std::memory_order_relaxed);
+
+    if (singleton->window_start_usec != 0) {
+        uint64_t elapsed = now - singleton->window_start_usec;
+        if (elapsed < RATE_WINDOW_USEC) {
+            return;
+        }
+        for (int i = 0; i < 3; i++) {
+            singleton->samples_per_second[i] = (counts[i] - singleton->window_samples[i]) * 1000000.0 / elapsed;
+        }
+        if (frame > singleton->window_start_frame) {
+            singleton->regenerations_per_frame = double(regeneration_count - singleton->window_regenerations) /
+                                                 double(frame - singleton->window_start_frame);
+        }
+    }
+    singleton->window_start_usec = now;
+    singleton->window_start_frame = frame;
+    for (int i = 0; i < 3; i++) {
+        singleton->window_samples[i] = counts[i];
+    }
+    singleton->window_regenerations = regeneration_count;
+}
+
+double SimplexMonitors::get_samples_per_second(int p_dimension)
+{
+    ERR_FAIL_INDEX_V(p_dimension - 1, 3, 0.0);
+    return samples_per_second[p_dimension - 1];
+}
+
+double SimplexMonitors::get_regenerations_per_frame()
+{
+    return regenerations_per_frame;
+}
+
+double SimplexMonitors::get_last_generation_usec()
+{
+    return (double)last_generation_usec.load(std::memory_order_relaxed);
+}
+
+double SimplexMonitors::get_average_generation_usec()
+{
+    uint64_t count = generations.load(std::memory_order_relaxed);
+    if (count == 0) {
+        return 0.0;
+    }
+    return (double)generation_usec_total.load(std::memory_order_relaxed) / count;
+}
+
+double SimplexMonitors::get_queued_jobs()
+{
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    return scheduler ? scheduler->get_queued_job_count() : 0.0;
+}
+
+double SimplexMonitors::get_in_flight_jobs()
+{
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    if (scheduler == nullptr) {
+        return 0.0;
+    }
+    // Running on a worker, or done and waiting for its main-thread finish step
+    return scheduler->get_running_job_count() + scheduler->get_pending_finish_count();
+}
+
+double SimplexMonitors::_hit_rate(Cache p_cache)
+{
+    uint64_t hits = cache_hits[p_cache].load(std::memory_order_relaxed);
+    uint64_t total = hits + cache_misses[p_cache].load(std::memory_order_relaxed);
+    return total == 0 ? 0.0 : (double)hits / total;
+}
+
+double SimplexMonitors::get_texture_cache_hit_rate()
+{
+    return _hit_rate(CACHE_TEXTURE);
+}
+
+double SimplexMonitors::get_field_cache_hit_rate()
+{
+    return _hit_rate(CACHE_FIELD);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace godot
+{
+    // Counters behind the "Simplex/..." custom monitors of the Performance singleton.
+    // Recording is a relaxed atomic add, cheap enough to stay enabled in release builds;
+    // rates are computed by update_rates once per frame, so any number of readers see the same values.
+    class SimplexMonitors : public Object {
+        GDCLASS(SimplexMonitors, Object)
+
+    protected:
+        static void _bind_methods();
+
+    public:
+        // The two caches of the textures, each with its own hit rate monitor
+        enum Cache {
+            CACHE_TEXTURE,  // get_image() / get_data() finding the texture up to date
+            CACHE_FIELD,    // a generation reusing the noise field of the previous one
+            CACHE_MAX,
+        };
+
+        static void add_samples(int p_dimension, uint64_t p_count) {
+            samples[p_dimension - 1].fetch_add(p_count, std::memory_order_relaxed);
+        }
+        static void add_generation(uint64_t p_usec);
+        static void add_regeneration() {
+            regenerations.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Call once per lookup
+        static void add_cache_access(Cache p_cache, bool p_hit) {
+            (p_hit ? cache_hits : cache_misses)[p_cache].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void register_monitors();
+        static void unregister_monitors();
+
+        // Called by SimplexScheduler on frame_pre_draw
+        static void update_rates();
+
+        double get_samples_per_second(int p_dimension);
+        double get_regenerations_per_frame();
+        double get_last_generation_usec();
+        double get_average_generation_usec();
+        double get_queued_jobs();
+        double get_in_flight_jobs();
+        double get_texture_cache_hit_rate();
+        double get_field_cache_hit_rate();
+
+    private:
+        static SimplexMonitors *singleton;
+
+        static std::atomic<uint64_t> samples[3];
+        static std::atomic<uint64_t> regenerations;
+        static std::atomic<uint64_t> generations;
+        static std::atomic<uint64_t> generation_usec_total;
+        static std::atomic<uint64_t> last_generation_usec;
+        static std::atomic<uint64_t> cache_hits[CACHE_MAX];
+        static std::atomic<uint64_t> cache_misses[CACHE_MAX];
+
+        static double _hit_rate(Cache p_cache);
+
+        // Rate bookkeeping, only touched by update_rates on the main thread. Rates are
+        // measured over windows of at least RATE_WINDOW_USEC to smooth out single frames.
+        static const uint64_t RATE_WINDOW_USEC = 250000;
+        uint64_t window_start_usec = 0;
+        uint64_t window_start_frame = 0;
+        uint64_t window_samples[3] = {};
+        uint64_t window_regenerations = 0;
+        double samples_per_second[3] = {};
+        double regenerations_per_frame = 0.0;
+    };
+} // namespace godot
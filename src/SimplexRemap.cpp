@@ -0,0 +1,55 @@
+#include "Simplex.hpp"
+
+#include <vector>
+
+using namespace godot;
+
+// Samples per baked curve; linear interpolation in between is well below 8-bit precision
+static const int CURVE_TABLE_SIZE = 1024;
+
+std::shared_ptr<const SimplexCurveTable> Simplex::bake_curve(const Ref<Curve> &p_curve)
+{
+    if (p_curve.is_null() || p_curve->get_point_count() == 0) {
+        return nullptr;
+    }
+    std::vector<float> samples(CURVE_TABLE_SIZE);
+    for (int i = 0; i < CURVE_TABLE_SIZE; i++) {
+        samples[i] = p_curve->sample_baked(i / float(CURVE_TABLE_SIZE - 1));
+    }
+    return std::make_shared<const SimplexCurveTable>(std::move(samples));
+}
+
+Simplex::~Simplex()
+{
+    if (remap_curve.is_valid()) {
+        remap_curve->disconnect("changed", Callable(this, "_on_remap_curve_changed"));
+    }
+}
+
+void Simplex::set_remap_curve(const Ref<Curve> &p_curve)
+{
+    if (remap_curve == p_curve) {
+        return;
+    }
+    if (remap_curve.is_valid()) {
+        remap_curve->disconnect("changed", Callable(this, "_on_remap_curve_changed"));
+    }
+    remap_curve = p_curve;
+    if (remap_curve.is_valid()) {
+        remap_curve->connect("changed", Callable(this, "_on_remap_curve_changed"));
+    }
+    _on_remap_curve_changed();
+}
+
+Ref<Curve> Simplex::get_remap_curve() const
+{
+    return remap_curve;
+}
+
+void Simplex::_on_remap_curve_changed()
+{
+    // Generators already copied to workers keep the table they were given
+    this->generator->mRemapCurve = bake_curve(remap_curve);
+    _update_preview();
+    emit_changed();
+}
@@ -0,0 +1,257 @@
+#include "SimplexScheduler.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+#include <vector>
+
+using namespace godot;
+
+SimplexScheduler *SimplexScheduler::singleton = nullptr;
+
+static const char *MAX_WORKERS_SETTING = "simplex/scheduler/max_workers";
+static const char *FRAME_BUDGET_SETTING = "simplex/scheduler/frame_budget_usec";
+// The setter clamps to the minimum of the range hint, so both agree
+static const int MIN_FRAME_BUDGET_USEC = 100;
+static const char *FRAME_BUDGET_HINT = "100,100000,100,suffix:us";
+
+static Variant _define_setting(const String &p_name, const Variant &p_default, PropertyHint p_hint, const String &p_hint_string)
+{
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    if (!settings->has_setting(p_name)) {
+        settings->set_setting(p_name, p_default);
+    }
+    settings->set_initial_value(p_name, p_default);
+
+    Dictionary info;
+    info["name"] = p_name;
+    info["type"] = (int)p_default.get_type();
+    info["hint"] = (int)p_hint;
+    info["hint_string"] = p_hint_string;
+    settings->add_property_info(info);
+
+    return settings->get_setting(p_name, p_default);
+}
+
+void SimplexScheduler::_bind_methods()
+{
+    ClassDB::bind_method(D_METHOD("set_max_workers", "workers"), &SimplexScheduler::set_max_workers);
+    ClassDB::bind_method(D_METHOD("get_max_workers"), &SimplexScheduler::get_max_workers);
+    ClassDB::bind_method(D_METHOD("get_worker_count"), &SimplexScheduler::get_worker_count);
+    ClassDB::bind_method(D_METHOD("set_frame_budget_usec", "usec"), &SimplexScheduler::set_frame_budget_usec);
+    ClassDB::bind_method(D_METHOD("get_frame_budget_usec"), &SimplexScheduler::get_frame_budget_usec);
+    ClassDB::bind_method(D_METHOD("get_queued_job_count"), &SimplexScheduler::get_queued_job_count);
+    ClassDB::bind_method(D_METHOD("get_running_job_count"), &SimplexScheduler::get_running_job_count);
+    ClassDB::bind_method(D_METHOD("get_pending_finish_count"), &SimplexScheduler::get_pending_finish_count);
+    ClassDB::bind_method(D_METHOD("get_frame_task_count"), &SimplexScheduler::get_frame_task_count);
+    ClassDB::bind_method(D_METHOD("flush"), &SimplexScheduler::flush);
+
+    ClassDB::bind_method(D_METHOD("_on_frame_pre_draw"), &SimplexScheduler::_on_frame_pre_draw);
+    ClassDB::bind_method(D_METHOD("_on_project_settings_changed"), &SimplexScheduler::_on_project_settings_changed);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_workers", PROPERTY_HINT_RANGE, "0,64,1"), "set_max_workers", "get_max_workers");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_budget_usec", PROPERTY_HINT_RANGE, FRAME_BUDGET_HINT), "set_frame_budget_usec", "get_frame_budget_usec");
+
+    BIND_ENUM_CONSTANT(PRIORITY_INTERACTIVE);
+    BIND_ENUM_CONSTANT(PRIORITY_NEAR_CAMERA);
+    BIND_ENUM_CONSTANT(PRIORITY_BACKGROUND);
+}
+
+void SimplexScheduler::create_singleton()
+{
+    singleton = memnew(SimplexScheduler);
+    Engine::get_singleton()->register_singleton("SimplexScheduler", singleton);
+}
+
+void SimplexScheduler::free_singleton()
+{
+    if (singleton) {
+        Engine::get_singleton()->unregister_singleton("SimplexScheduler");
+        memdelete(singleton);
+        singleton = nullptr;
+    }
+}
+
+SimplexScheduler::SimplexScheduler()
+{
+    // 0 workers means one less than the number of cores, leaving the main thread alone
+    max_workers = _define_setting(MAX_WORKERS_SETTING, 0, PROPERTY_HINT_RANGE, "0,64,1");
+    set_frame_budget_usec(_define_setting(FRAME_BUDGET_SETTING, 2000, PROPERTY_HINT_RANGE, FRAME_BUDGET_HINT));
+
+    pool = std::make_unique<SimplexJobPool>((unsigned int)MAX(0, max_workers));
+
+    RenderingServer::get_singleton()->connect("frame_pre_draw", Callable(this, "_on_frame_pre_draw"));
+    ProjectSettings::get_singleton()->connect("settings_changed", Callable(this, "_on_project_settings_changed"));
+}
+
+SimplexScheduler::~SimplexScheduler()
+{
+    RenderingServer::get_singleton()->disconnect("frame_pre_draw", Callable(this, "_on_frame_pre_draw"));
+    ProjectSettings::get_singleton()->disconnect("settings_changed", Callable(this, "_on_project_settings_changed"));
+
+    // Joins the workers; finish steps of jobs still in flight are dropped with the queues,
+    // unfinished frame tasks with the map
+    pool.reset();
+}
+
+uint64_t SimplexScheduler::submit(Priority p_priority, std::function<void()> p_work, std::function<void()> p_finish)
+{
+    SimplexJobPool::Priority priority = (SimplexJobPool::Priority)p_priority;
+    return pool->submit(priority, [this, p_priority, work = std::move(p_work), finish = std::move(p_finish)]() mutable {
+        work();
+        if (finish) {
+            std::lock_guard<std::mutex> lock(finish_mutex);
+            finish_queues[p_priority].push_back(std::move(finish));
+        }
+    });
+}
+
+bool SimplexScheduler::cancel(uint64_t p_job)
+{
+    return pool->cancel(p_job);
+}
+
+uint64_t SimplexScheduler::add_frame_task(std::function<bool()> p_step)
+{
+    ERR_FAIL_COND_V(!p_step, 0);
+    uint64_t task = next_frame_task++;
+    frame_tasks[task] = std::move(p_step);
+    return task;
+}
+
+void SimplexScheduler::remove_frame_task(uint64_t p_task)
+{
+    frame_tasks.erase(p_task);
+}
+
+void SimplexScheduler::parallel_for(int p_count, Priority p_priority, const std::function<void(int, int)> &p_body, int p_grain)
+{
+    if (singleton == nullptr) {
+        p_body(0, p_count);
+        return;
+    }
+    singleton->pool->parallelFor(p_count, (SimplexJobPool::Priority)p_priority, p_body, p_grain);
+}
+
+void SimplexScheduler::set_max_workers(int p_workers)
+{
+    max_workers = MAX(0, p_workers);
+    pool->setWorkerCount((unsigned int)max_workers);
+}
+
+int SimplexScheduler::get_max_workers() const
+{
+    return max_workers;
+}
+
+int SimplexScheduler::get_worker_count() const
+{
+    return (int)pool->getWorkerCount();
+}
+
+void SimplexScheduler::set_frame_budget_usec(int p_usec)
+{
+    frame_budget_usec = MAX(MIN_FRAME_BUDGET_USEC, p_usec);
+}
+
+int SimplexScheduler::get_frame_budget_usec() const
+{
+    return frame_budget_usec;
+}
+
+int SimplexScheduler::get_queued_job_count() const
+{
+    return (int)pool->getQueuedCount();
+}
+
+int SimplexScheduler::get_running_job_count() const
+{
+    return (int)pool->getRunningCount();
+}
+
+int SimplexScheduler::get_pending_finish_count() const
+{
+    std::lock_guard<std::mutex> lock(finish_mutex);
+    size_t count = 0;
+    for (const std::deque<std::function<void()>> &queue : finish_queues) {
+        count += queue.size();
+    }
+    return (int)count;
+}
+
+int SimplexScheduler::get_frame_task_count() const
+{
+    return (int)frame_tasks.size();
+}
+
+bool SimplexScheduler::_pop_finish(std::function<void()> &r_finish)
+{
+    std::lock_guard<std::mutex> lock(finish_mutex);
+    for (std::deque<std::function<void()>> &queue : finish_queues) {
+        if (!queue.empty()) {
+            r_finish = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimplexScheduler::flush()
+{
+    SIMPLEX_TRACE_ZONE("SimplexScheduler::flush");
+    std::function<void()> finish;
+    while (_pop_finish(finish)) {
+        finish();
+    }
+}
+
+void SimplexScheduler::_on_frame_pre_draw()
+{
+    SIMPLEX_TRACE_ZONE("SimplexScheduler::_on_frame_pre_draw");
+    SimplexMonitors::update_rates();
+
+    if (!frame_tasks.empty()) {
+        // A step may add or remove tasks, so walk a snapshot of the ids and keep the
+        // step alive in a copy while it runs
+        std::vector<uint64_t> tasks;
+        tasks.reserve(frame_tasks.size());
+        for (const std::pair<const uint64_t, std::function<bool()>> &task : frame_tasks) {
+            tasks.push_back(task.first);
+        }
+        for (uint64_t task : tasks) {
+            std::map<uint64_t, std::function<bool()>>::iterator it = frame_tasks.find(task);
+            if (it == frame_tasks.end()) {
+                continue;
+            }
+            std::function<bool()> step = it->second;
+            if (!step()) {
+                frame_tasks.erase(task);
+            }
+        }
+    }
+
+    // Always make progress by at least one finish step, then stop once the budget is spent
+    uint64_t start = Time::get_singleton()->get_ticks_usec();
+    uint64_t finished = 0;
+    std::function<void()> finish;
+    while (_pop_finish(finish)) {
+        finish();
+        finished++;
+        if (Time::get_singleton()->get_ticks_usec() - start >= (uint64_t)frame_budget_usec) {
+            break;
+        }
+    }
+    SIMPLEX_TRACE_VALUE(finished);
+}
+
+void SimplexScheduler::_on_project_settings_changed()
+{
+    ProjectSettings *settings = ProjectSettings::get_singleton();
+    set_max_workers(settings->get_setting(MAX_WORKERS_SETTING, max_workers));
+    set_frame_budget_usec(settings->get_setting(FRAME_BUDGET_SETTING, frame_budget_usec));
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include "lib/SimplexJobPool.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace godot
+{
+    // Plugin-wide scheduler for noise generation. Work runs on a SimplexJobPool sized by the
+    // "simplex/scheduler/max_workers" project setting; the main-thread half of each job
+    // (texture uploads and signals) is drained once per frame within
+    // "simplex/scheduler/frame_budget_usec", most urgent priority class first.
+    class SimplexScheduler : public Object {
+        GDCLASS(SimplexScheduler, Object)
+
+    protected:
+        static void _bind_methods();
+
+    public:
+        enum Priority {
+            PRIORITY_INTERACTIVE = SimplexJobPool::PRIORITY_INTERACTIVE,
+            PRIORITY_NEAR_CAMERA = SimplexJobPool::PRIORITY_NEAR,
+            PRIORITY_BACKGROUND = SimplexJobPool::PRIORITY_BACKGROUND,
+        };
+
+        static SimplexScheduler *get_singleton() { return singleton; }
+        static void create_singleton();
+        static void free_singleton();
+
+        // Queue p_work on a worker; p_finish then runs on the main thread during a later frame.
+        uint64_t submit(Priority p_priority, std::function<void()> p_work, std::function<void()> p_finish = nullptr);
+        bool cancel(uint64_t p_job);
+
+        // Call p_step on the main thread once per frame, before the finish steps, until it
+        // returns false. For work that has to stay on the main thread but does not fit in one
+        // frame: p_step keeps to its own time budget.
+        uint64_t add_frame_task(std::function<bool()> p_step);
+        void remove_frame_task(uint64_t p_task);
+
+        // Split [0, p_count) across the workers and the calling thread, blocking until done.
+        // Runs inline when the scheduler does not exist (e.g. before SCENE initialization).
+        static void parallel_for(int p_count, Priority p_priority, const std::function<void(int, int)> &p_body, int p_grain = 1);
+
+        void set_max_workers(int p_workers);
+        int get_max_workers() const;
+        // Threads actually running, max_workers resolved when it is 0 (automatic)
+        int get_worker_count() const;
+        void set_frame_budget_usec(int p_usec);
+        int get_frame_budget_usec() const;
+
+        int get_queued_job_count() const;
+        int get_running_job_count() const;
+        int get_pending_finish_count() const;
+        int get_frame_task_count() const;
+
+        // Run every pending main-thread finish step now, ignoring the frame budget
+        void flush();
+
+        SimplexScheduler();
+        ~SimplexScheduler();
+
+    private:
+        static SimplexScheduler *singleton;
+
+        std::unique_ptr<SimplexJobPool> pool;
+        int max_workers;
+        int frame_budget_usec;
+
+        mutable std::mutex finish_mutex;
+        std::deque<std::function<void()>> finish_queues[SimplexJobPool::PRIORITY_MAX];
+
+        // Main thread only, ordered by id so older tasks step first
+        std::map<uint64_t, std::function<bool()>> frame_tasks;
+        uint64_t next_frame_task = 1;
+
+        bool _pop_finish(std::function<void()> &r_finish);
+        void _on_frame_pre_draw();
+        void _on_project_settings_changed();
+    };
+} // namespace godot
+
+VARIANT_ENUM_CAST(SimplexScheduler::Priority);
@@ -0,0 +1,375 @@
+#include "Simplex.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+#include <vector>
+
+using namespace godot;
+
+Error Simplex::_stream_slices(int32_t p_width, int32_t p_height, int32_t p_depth, bool p_seamless, float p_skirt,
+    const std::function<Error(int, int, const float *)> &p_sink) const
+{
+    SIMPLEX_TRACE_ZONE("Simplex::_stream_slices");
+    // One slice per worker plus the calling thread keeps every core busy with the least memory
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    int batch = MIN(p_depth, scheduler != nullptr ? scheduler->get_worker_count() + 1 : 1);
+    size_t slice_size = (size_t)p_width * p_height;
+    std::vector<float> values(slice_size * batch);
+
+    // Snapshot, so edits made by the callback do not change the rest of the volume
+    const SimplexGenerator generator = *this->generator;
+    for (int first = 0; first < p_depth; first += batch) {
+        int last = MIN(first + batch, p_depth);
+        SimplexMonitors::add_samples(3, slice_size * (last - first));
+        SimplexScheduler::parallel_for(last - first, SimplexScheduler::PRIORITY_INTERACTIVE, [&](int p_begin, int p_end) {
+            generator.fillSlices3D(values.data() + p_begin * slice_size, p_width, p_height, p_depth, p_seamless, p_skirt,
+                first + p_begin, first + p_end);
+        });
+
+        Error err = p_sink(first, last - first, values.data());
+        if (err != OK) {
+            return err;
+        }
+    }
+    return OK;
+}
+
+Error Simplex::stream_image_3d(const Callable &p_callback, int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert,
+    bool p_seamless, float p_skirt, bool p_normalize, Image::Format p_format) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0 || p_depth <= 0, ERR_INVALID_PARAMETER, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), ERR_INVALID_PARAMETER, "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    ERR_FAIL_COND_V_MSG(!p_callback.is_valid(), ERR_INVALID_PARAMETER, "Invalid slice callback.");
+    SIMPLEX_TRACE_ZONE("Simplex::stream_image_3d");
+
+    size_t slice_size = (size_t)p_width * p_height;
+    return _stream_slices(p_width, p_height, p_depth, p_seamless, p_skirt, [&](int p_first, int p_count, const float *p_values) {
+        for (int i = 0; i < p_count; i++) {
+            Ref<Image> slice = create_image(p_values + i * slice_size, p_width, p_height, p_invert, p_normalize, p_format);
+            Variant ret = p_callback.call(p_first + i, slice);
+            if (ret.get_type() == Variant::BOOL && !ret.operator bool()) {
+                return ERR_SKIP;
+            }
+        }
+        return OK;
+    });
+}
+
+Error Simplex::write_volume(const Ref<FileAccess> &p_file, int32_t p_width, int32_t p_height, int32_t p_depth, bool p_invert,
+    bool p_seamless, float p_skirt, bool p_normalize, Image::Format p_format) const
+{
+    ERR_FAIL_COND_V_MSG(p_file.is_null(), ERR_INVALID_PARAMETER, "File is null.");
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0 || p_depth <= 0, ERR_INVALID_PARAMETER, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), ERR_INVALID_PARAMETER, "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    SIMPLEX_TRACE_ZONE("Simplex::write_volume");
+
+    size_t slice_size = (size_t)p_width * p_height;
+    PackedByteArray bytes;
+    return _stream_slices(p_width, p_height, p_depth, p_seamless, p_skirt, [&](int p_first, int p_count, const float *p_values) {
+        int64_t count = (int64_t)slice_size * p_count;
+        bytes.resize(count * image_format_pixel_size(p_format));
+        encode_pixels(p_values, count, p_invert, p_normalize, p_format, bytes.ptrw());
+        p_file->store_buffer(bytes);
+        return p_file->get_error();
+    });
+}
+
+struct Simplex::SlicedImage {
+    SimplexGenerator generator;
+    Callable callback;
+    int32_t width;
+    int32_t height;
+    int32_t depth;      // 0 for a 2D image
+    bool invert;
+    bool in_3d_space;
+    bool seamless;
+    float skirt;
+    bool normalize;
+    Image::Format format;
+    int32_t budget_usec;
+    int band_rows;      // rows generated at a time, a whole slice for volumes
+    int next_row = 0;   // counted across the slices of a volume
+    std::vector<float> values;
+    PackedByteArray pixels;
+};
+
+Error Simplex::get_image_sliced(const Callable &p_callback, int32_t p_width, int32_t p_height, bool p_invert,
+    bool p_in_3d_space, bool p_seamless, float p_skirt, bool p_normalize, Image::Format p_format, int32_t p_budget_usec) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0, ERR_INVALID_PARAMETER, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), ERR_INVALID_PARAMETER, "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    ERR_FAIL_COND_V_MSG(!p_callback.is_valid(), ERR_INVALID_PARAMETER, "Invalid image callback.");
+
+    std::shared_ptr<SlicedImage> image = std::make_shared<SlicedImage>();
+    image->generator = *generator;
+    image->callback = p_callback;
+    image->width = p_width;
+    image->height = p_height;
+    image->depth = 0;
+    image->invert = p_invert;
+    image->in_3d_space = p_in_3d_space;
+    image->seamless = p_seamless;
+    image->skirt = p_skirt;
+    image->normalize = p_normalize;
+    image->format = p_format;
+    image->budget_usec = MAX(0, p_budget_usec);
+    image->band_rows = MAX(1, 4096 / p_width);
+    _start_sliced_image(image);
+    return OK;
+}
+
+Error Simplex::get_image_3d_sliced(const Callable &p_callback, int32_t p_width, int32_t p_height, int32_t p_depth,
+    bool p_invert, bool p_seamless, float p_skirt, bool p_normalize, Image::Format p_format, int32_t p_budget_usec) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0 || p_depth <= 0, ERR_INVALID_PARAMETER, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(!is_supported_image_format(p_format), ERR_INVALID_PARAMETER, "Unsupported image format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    ERR_FAIL_COND_V_MSG(!p_callback.is_valid(), ERR_INVALID_PARAMETER, "Invalid image callback.");
+
+    std::shared_ptr<SlicedImage> image = std::make_shared<SlicedImage>();
+    image->generator = *generator;
+    image->callback = p_callback;
+    image->width = p_width;
+    image->height = p_height;
+    image->depth = p_depth;
+    image->invert = p_invert;
+    image->in_3d_space = true;
+    image->seamless = p_seamless;
+    image->skirt = p_skirt;
+    image->normalize = p_normalize;
+    image->format = p_format;
+    image->budget_usec = MAX(0, p_budget_usec);
+    image->band_rows = p_height;
+    _start_sliced_image(image);
+    return OK;
+}
+
+void Simplex::_start_sliced_image(const std::shared_ptr<SlicedImage> &p_image)
+{
+    // Only the band being generated is kept as floats, the finished rows as texels
+    int64_t count = (int64_t)p_image->width * p_image->height * MAX(1, p_image->depth);
+    p_image->values.resize((size_t)p_image->width * p_image->band_rows);
+    p_image->pixels.resize(count * image_format_pixel_size(p_image->format));
+
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    if (scheduler == nullptr) {
+        while (_step_sliced_image(*p_image)) {
+        }
+        return;
+    }
+    scheduler->add_frame_task([p_image]() {
+        return _step_sliced_image(*p_image);
+    });
+}
+
+bool Simplex::_step_sliced_image(SlicedImage &p_image)
+{
+    SIMPLEX_TRACE_ZONE("Simplex::_step_sliced_image");
+    int rows = p_image.height * MAX(1, p_image.depth);
+    int pixel_size = image_format_pixel_size(p_image.format);
+
+    if (p_image.next_row < rows) {
+        Time *time = Time::get_singleton();
+        uint64_t start = time->get_ticks_usec();
+        // At least one band per frame, so a budget smaller than a band still makes progress
+        do {
+            int begin = p_image.next_row;
+            int end = MIN(begin + p_image.band_rows, rows);
+            if (p_image.depth > 0) {
+                p_image.generator.fillSlices3D(p_image.values.data(), p_image.width, p_image.height, p_image.depth,
+                    p_image.seamless, p_image.skirt, begin / p_image.height, end / p_image.height);
+            } else {
+                p_image.generator.fillTile2D(p_image.values.data(), p_image.width, p_image.height, p_image.seamless,
+                    p_image.in_3d_space, p_image.skirt, 0, begin, p_image.width, end - begin);
+            }
+            int64_t count = (int64_t)(end - begin) * p_image.width;
+            SimplexMonitors::add_samples(p_image.in_3d_space ? 3 : 2, count);
+            encode_pixels(p_image.values.data(), count, p_image.invert, p_image.normalize, p_image.format,
+                p_image.pixels.ptrw() + (int64_t)begin * p_image.width * pixel_size);
+            p_image.next_row = end;
+        } while (p_image.next_row < rows && time->get_ticks_usec() - start < (uint64_t)p_image.budget_usec);
+        SIMPLEX_TRACE_VALUE(p_image.next_row);
+        return true;
+    }
+
+    // The images are handed over in a frame of their own, the callback may be expensive too.
+    // A callback whose object was freed meanwhile is dropped.
+    if (!p_image.callback.is_valid()) {
+        return false;
+    }
+    if (p_image.depth == 0) {
+        p_image.callback.call(Image::create_from_data(p_image.width, p_image.height, false, p_image.format, p_image.pixels));
+        return false;
+    }
+    int64_t slice_bytes = (int64_t)p_image.width * p_image.height * pixel_size;
+    TypedArray<Image> images;
+    images.resize(p_image.depth);
+    for (int z = 0; z < p_image.depth; z++) {
+        images[z] = Image::create_from_data(p_image.width, p_image.height, false, p_image.format,
+            p_image.pixels.slice(z * slice_bytes, (z + 1) * slice_bytes));
+    }
+    p_image.callback.call(images);
+    return false;
+}
+
+struct Simplex::TileExport {
+    SimplexGenerator generator;
+    int32_t width;
+    int32_t height;
+    SimplexExport::Format format;
+    bool invert;
+    bool in_3d_space;
+    bool seamless;
+    float skirt;
+    bool normalize;
+    int32_t tile_size;
+    String directory;
+};
+
+void Simplex::_fill_heights(const TileExport &p_export, float *r_heights, int32_t p_x0, int32_t p_y0,
+    int32_t p_tile_width, int32_t p_tile_height)
+{
+    SimplexMonitors::add_samples(p_export.in_3d_space ? 3 : 2, (uint64_t)p_tile_width * p_tile_height);
+    int grain = MAX(1, 4096 / p_tile_width);
+    SimplexScheduler::parallel_for(p_tile_height, SimplexScheduler::PRIORITY_INTERACTIVE, [&](int p_begin, int p_end) {
+        float *rows = r_heights + (size_t)p_begin * p_tile_width;
+        size_t count = (size_t)(p_end - p_begin) * p_tile_width;
+        p_export.generator.fillTile2D(rows, p_export.width, p_export.height, p_export.seamless, p_export.in_3d_space,
+            p_export.skirt, p_x0, p_y0 + p_begin, p_tile_width, p_end - p_begin);
+        SimplexPost::toHeights(rows, rows, count, p_export.normalize, p_export.invert);
+    }, grain);
+}
+
+static Error write_heights(const String &p_path, SimplexExport::Format p_format, int32_t p_width, int32_t p_height,
+    const std::function<bool(SimplexExport::HeightWriter &)> &p_body)
+{
+    Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+    ERR_FAIL_COND_V_MSG(file.is_null(), FileAccess::get_open_error(), "Cannot open '" + p_path + "' for writing.");
+
+    PackedByteArray bytes;
+    SimplexExport::HeightWriter writer(p_format, p_width, p_height, [&](const uint8_t *p_data, size_t p_size) {
+        bytes.resize(p_size);
+        memcpy(bytes.ptrw(), p_data, p_size);
+        file->store_buffer(bytes);
+        return file->get_error() == OK;
+    });
+    if (!p_body(writer) || !writer.finish()) {
+        return file->get_error() != OK ? file->get_error() : ERR_FILE_CANT_WRITE;
+    }
+    return OK;
+}
+
+Error Simplex::export_heightmap(const String &p_path, int32_t p_width, int32_t p_height, ExportFormat p_format,
+    bool p_invert, bool p_in_3d_space, bool p_seamless, float p_skirt, bool p_normalize, int32_t p_tile_size) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0, ERR_INVALID_PARAMETER, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(p_tile_size <= 0, ERR_INVALID_PARAMETER, "Tile size must be positive.");
+    ERR_FAIL_INDEX_V(p_format, EXPORT_FORMAT_EXR + 1, ERR_INVALID_PARAMETER);
+    SIMPLEX_TRACE_ZONE("Simplex::export_heightmap");
+
+    TileExport tiles{ *generator, p_width, p_height, (SimplexExport::Format)p_format, p_invert, p_in_3d_space,
+        p_seamless, p_skirt, p_normalize, p_tile_size, String() };
+
+    // Every format is a top to bottom scanline stream, so tiles are produced a full row at a time
+    std::vector<float> band((size_t)p_width * MIN(p_tile_size, p_height));
+    return write_heights(p_path, tiles.format, p_width, p_height, [&](SimplexExport::HeightWriter &r_writer) {
+        for (int32_t y = 0; y < p_height; y += p_tile_size) {
+            int32_t rows = MIN(p_tile_size, p_height - y);
+            _fill_heights(tiles, band.data(), 0, y, p_width, rows);
+            if (!r_writer.writeRows(band.data(), rows)) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+// Pyramid level sizes round up, so odd edges keep their last pixel
+static int32_t level_size(int32_t p_size, int p_level)
+{
+    for (int i = 0; i < p_level; i++) {
+        p_size = (p_size + 1) / 2;
+    }
+    return p_size;
+}
+
+static String level_directory(const String &p_directory, int p_level)
+{
+    return p_directory.path_join(String::num_int64(p_level));
+}
+
+Error Simplex::_export_pyramid_tile(const TileExport &p_export, int p_level, int p_x, int p_y, std::vector<float> &r_heights)
+{
+    int32_t level_width = level_size(p_export.width, p_level);
+    int32_t level_height = level_size(p_export.height, p_level);
+    int32_t tile = p_export.tile_size;
+    int32_t tile_width = MIN(tile, level_width - p_x * tile);
+    int32_t tile_height = MIN(tile, level_height - p_y * tile);
+    r_heights.resize((size_t)tile_width * tile_height);
+
+    if (p_level == 0) {
+        _fill_heights(p_export, r_heights.data(), p_x * tile, p_y * tile, tile_width, tile_height);
+    } else {
+        // Assemble the up to 2x2 children (each written out on the way), then halve them
+        int32_t child_width = level_size(p_export.width, p_level - 1);
+        int32_t child_height = level_size(p_export.height, p_level - 1);
+        int32_t region_width = MIN(2 * tile, child_width - 2 * p_x * tile);
+        int32_t region_height = MIN(2 * tile, child_height - 2 * p_y * tile);
+        std::vector<float> region((size_t)region_width * region_height);
+        std::vector<float> child;
+        for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 2; i++) {
+                int cx = 2 * p_x + i, cy = 2 * p_y + j;
+                if (cx * tile >= child_width || cy * tile >= child_height) {
+                    continue;
+                }
+                Error err = _export_pyramid_tile(p_export, p_level - 1, cx, cy, child);
+                if (err != OK) {
+                    return err;
+                }
+                int32_t cw = MIN(tile, child_width - cx * tile);
+                int32_t ch = MIN(tile, child_height - cy * tile);
+                for (int32_t y = 0; y < ch; y++) {
+                    std::copy(child.begin() + (size_t)y * cw, child.begin() + (size_t)(y + 1) * cw,
+                        region.begin() + (size_t)(j * tile + y) * region_width + i * tile);
+                }
+            }
+        }
+        SimplexExport::downsample(region.data(), region_width, region_height, r_heights.data());
+    }
+
+    String path = level_directory(p_export.directory, p_level).path_join(String::num_int64(p_x) + "_" + String::num_int64(p_y) + "." +
+        SimplexExport::extension(p_export.format));
+    return write_heights(path, p_export.format, tile_width, tile_height, [&](SimplexExport::HeightWriter &r_writer) {
+        return r_writer.writeRows(r_heights.data(), tile_height);
+    });
+}
+
+Error Simplex::export_tile_pyramid(const String &p_directory, int32_t p_width, int32_t p_height, ExportFormat p_format,
+    bool p_invert, bool p_in_3d_space, bool p_seamless, float p_skirt, bool p_normalize, int32_t p_tile_size) const
+{
+    ERR_FAIL_COND_V_MSG(p_width <= 0 || p_height <= 0, ERR_INVALID_PARAMETER, "Image size must be positive.");
+    ERR_FAIL_COND_V_MSG(p_tile_size <= 0, ERR_INVALID_PARAMETER, "Tile size must be positive.");
+    ERR_FAIL_INDEX_V(p_format, EXPORT_FORMAT_EXR + 1, ERR_INVALID_PARAMETER);
+    SIMPLEX_TRACE_ZONE("Simplex::export_tile_pyramid");
+
+    TileExport tiles{ *generator, p_width, p_height, (SimplexExport::Format)p_format, p_invert, p_in_3d_space,
+        p_seamless, p_skirt, p_normalize, p_tile_size, p_directory };
+
+    // The top level is the first one that fits in a single tile
+    int top = 0;
+    while (level_size(p_width, top) > p_tile_size || level_size(p_height, top) > p_tile_size) {
+        top++;
+    }
+    for (int level = 0; level <= top; level++) {
+        String directory = level_directory(p_directory, level);
+        Error err = DirAccess::make_dir_recursive_absolute(directory);
+        ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot create '" + directory + "'.");
+    }
+
+    // Depth first from the top tile: only one 2x2 block of children per level is alive at a time
+    std::vector<float> heights;
+    return _export_pyramid_tile(tiles, top, 0, 0, heights);
+}
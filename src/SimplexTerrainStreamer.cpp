@@ -0,0 +1,496 @@
+#include "SimplexTerrainStreamer.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
+
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/core/object.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+SimplexTerrainStreamer::SimplexTerrainStreamer() :
+    chunk_size(64.0f),
+    chunk_subdivisions(31),
+    amplitude(32.0f),
+    view_distance(4),
+    generate_collision(false),
+    upload_budget_usec(2000),
+    center_chunk(0, 0),
+    layout_dirty(true),
+    version(1),
+    in_flight(0) {
+}
+
+SimplexTerrainStreamer::~SimplexTerrainStreamer() {
+    // Jobs still running find no streamer when they finish and are dropped
+    _clear();
+    if (noise.is_valid()) {
+        noise->disconnect("changed", Callable(this, "_on_noise_changed"));
+    }
+}
+
+void SimplexTerrainStreamer::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_noise", "noise"), &SimplexTerrainStreamer::set_noise);
+    ClassDB::bind_method(D_METHOD("get_noise"), &SimplexTerrainStreamer::get_noise);
+    ClassDB::bind_method(D_METHOD("set_target", "target"), &SimplexTerrainStreamer::set_target);
+    ClassDB::bind_method(D_METHOD("get_target"), &SimplexTerrainStreamer::get_target);
+    ClassDB::bind_method(D_METHOD("set_chunk_size", "size"), &SimplexTerrainStreamer::set_chunk_size);
+    ClassDB::bind_method(D_METHOD("get_chunk_size"), &SimplexTerrainStreamer::get_chunk_size);
+    ClassDB::bind_method(D_METHOD("set_chunk_subdivisions", "subdivisions"), &SimplexTerrainStreamer::set_chunk_subdivisions);
+    ClassDB::bind_method(D_METHOD("get_chunk_subdivisions"), &SimplexTerrainStreamer::get_chunk_subdivisions);
+    ClassDB::bind_method(D_METHOD("set_amplitude", "amplitude"), &SimplexTerrainStreamer::set_amplitude);
+    ClassDB::bind_method(D_METHOD("get_amplitude"), &SimplexTerrainStreamer::get_amplitude);
+    ClassDB::bind_method(D_METHOD("set_view_distance", "distance"), &SimplexTerrainStreamer::set_view_distance);
+    ClassDB::bind_method(D_METHOD("get_view_distance"), &SimplexTerrainStreamer::get_view_distance);
+    ClassDB::bind_method(D_METHOD("set_material", "material"), &SimplexTerrainStreamer::set_material);
+    ClassDB::bind_method(D_METHOD("get_material"), &SimplexTerrainStreamer::get_material);
+    ClassDB::bind_method(D_METHOD("set_generate_collision", "enabled"), &SimplexTerrainStreamer::set_generate_collision);
+    ClassDB::bind_method(D_METHOD("get_generate_collision"), &SimplexTerrainStreamer::get_generate_collision);
+    ClassDB::bind_method(D_METHOD("set_upload_budget_usec", "usec"), &SimplexTerrainStreamer::set_upload_budget_usec);
+    ClassDB::bind_method(D_METHOD("get_upload_budget_usec"), &SimplexTerrainStreamer::get_upload_budget_usec);
+    ClassDB::bind_method(D_METHOD("get_loaded_chunk_count"), &SimplexTerrainStreamer::get_loaded_chunk_count);
+    ClassDB::bind_method(D_METHOD("get_pending_chunk_count"), &SimplexTerrainStreamer::get_pending_chunk_count);
+    ClassDB::bind_method(D_METHOD("regenerate"), &SimplexTerrainStreamer::regenerate);
+    ClassDB::bind_method(D_METHOD("_on_noise_changed"), &SimplexTerrainStreamer::_on_noise_changed);
+
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "noise", PROPERTY_HINT_RESOURCE_TYPE, "Simplex"), "set_noise", "get_noise");
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "target", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "Node3D"), "set_target", "get_target");
+    ADD_GROUP("Chunks", "");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "chunk_size", PROPERTY_HINT_RANGE, "1,1024,1,or_greater,suffix:m"), "set_chunk_size", "get_chunk_size");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_subdivisions", PROPERTY_HINT_RANGE, "0,254,1"), "set_chunk_subdivisions", "get_chunk_subdivisions");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "amplitude", PROPERTY_HINT_RANGE, "0,1000,0.1,or_greater,suffix:m"), "set_amplitude", "get_amplitude");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "view_distance", PROPERTY_HINT_RANGE, "0,64,1"), "set_view_distance", "get_view_distance");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "material", PROPERTY_HINT_RESOURCE_TYPE, "BaseMaterial3D,ShaderMaterial"), "set_material", "get_material");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "generate_collision"), "set_generate_collision", "get_generate_collision");
+    ADD_GROUP("Streaming", "");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "upload_budget_usec", PROPERTY_HINT_RANGE, "100,100000,100,suffix:us"), "set_upload_budget_usec", "get_upload_budget_usec");
+}
+
+void SimplexTerrainStreamer::_notification(int p_what) {
+    switch (p_what) {
+        case NOTIFICATION_ENTER_TREE:
+            layout_dirty = true;
+            set_process(true);
+            break;
+        case NOTIFICATION_EXIT_TREE:
+            _clear();
+            break;
+        case NOTIFICATION_PROCESS: {
+            if (noise.is_null() || chunk_size <= 0.0f) {
+                return;
+            }
+            SIMPLEX_TRACE_ZONE("SimplexTerrainStreamer process");
+            Vector3 position = _get_target_position();
+            Vector2i center((int)Math::floor(position.x / chunk_size), (int)Math::floor(position.z / chunk_size));
+            if (center != center_chunk || layout_dirty) {
+                center_chunk = center;
+                _update_wanted();
+            }
+            _dispatch();
+            _upload();
+        } break;
+    }
+}
+
+void SimplexTerrainStreamer::_on_noise_changed() {
+    _invalidate();
+}
+
+void SimplexTerrainStreamer::_invalidate() {
+    // Chunks on screen stay until their replacement is uploaded
+    version++;
+    layout_dirty = true;
+}
+
+int SimplexTerrainStreamer::_get_columns() const {
+    return chunk_subdivisions + 2;
+}
+
+Vector3 SimplexTerrainStreamer::_get_target_position() const {
+    Node3D *node = nullptr;
+    if (!target.is_empty()) {
+        node = Object::cast_to<Node3D>(get_node_or_null(target));
+    } else if (get_viewport() != nullptr) {
+        node = get_viewport()->get_camera_3d();
+    }
+    if (node == nullptr) {
+        return Vector3();
+    }
+    return to_local(node->get_global_position());
+}
+
+void SimplexTerrainStreamer::_update_wanted() {
+    SIMPLEX_TRACE_ZONE("SimplexTerrainStreamer::_update_wanted");
+    layout_dirty = false;
+
+    // Up-to-date chunks are kept one ring past view_distance, so walking back and forth over a
+    // chunk border does not free and rebuild the same row every time. Outdated ones in that ring
+    // (after a noise or layout change) are freed rather than left showing the old terrain; those
+    // still generating are kept for their result.
+    float radius = view_distance + 0.5f;
+    float keep = view_distance + 1.5f;
+    for (std::map<Vector2i, Chunk>::iterator it = chunks.begin(); it != chunks.end();) {
+        Vector2i delta = it->first - center_chunk;
+        int distance_squared = delta.x * delta.x + delta.y * delta.y;
+        bool outdated = !it->second.queued && it->second.version != version;
+        if (distance_squared > keep * keep || (outdated && distance_squared > radius * radius)) {
+            _unload(it++);
+        } else {
+            ++it;
+        }
+    }
+
+    pending.clear();
+    for (int z = -view_distance; z <= view_distance; z++) {
+        for (int x = -view_distance; x <= view_distance; x++) {
+            if (x * x + z * z > radius * radius) {
+                continue;
+            }
+            Vector2i coord = center_chunk + Vector2i(x, z);
+            Chunk &chunk = chunks[coord];
+            if (!chunk.queued && chunk.version != version) {
+                pending.push_back(coord);
+            }
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [this](const Vector2i &p_a, const Vector2i &p_b) {
+        Vector2i a = p_a - center_chunk;
+        Vector2i b = p_b - center_chunk;
+        return a.x * a.x + a.y * a.y > b.x * b.x + b.y * b.y;
+    });
+}
+
+void SimplexTerrainStreamer::_dispatch() {
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    ERR_FAIL_NULL(scheduler);
+    // Only a couple of chunks per worker are queued at a time, so the order still follows the
+    // target when it moves; the rest wait in pending, nearest last
+    int limit = MAX(1, scheduler->get_worker_count()) * 2;
+    uint64_t id = get_instance_id();
+    while (in_flight < limit && !pending.empty()) {
+        Vector2i coord = pending.back();
+        pending.pop_back();
+        std::map<Vector2i, Chunk>::iterator it = chunks.find(coord);
+        if (it == chunks.end() || it->second.queued) {
+            continue;
+        }
+
+        std::shared_ptr<ChunkJob> job = std::make_shared<ChunkJob>();
+        job->coord = coord;
+        job->version = version;
+        job->generator = noise->get_generator();
+        job->origin = (Vector2(coord) + Vector2(0.5f, 0.5f)) * chunk_size;
+        job->chunk_size = chunk_size;
+        job->columns = _get_columns();
+        job->amplitude = amplitude;
+        job->collision = generate_collision;
+        if (free_buffers.empty()) {
+            job->buffers = std::make_unique<ChunkBuffers>();
+        } else {
+            job->buffers = std::move(free_buffers.back());
+            free_buffers.pop_back();
+        }
+
+        Vector2i delta = coord - center_chunk;
+        SimplexScheduler::Priority priority = delta.x * delta.x + delta.y * delta.y <= 2 ?
+            SimplexScheduler::PRIORITY_NEAR_CAMERA : SimplexScheduler::PRIORITY_BACKGROUND;
+        job->id = scheduler->submit(priority,
+            [job]() {
+                _generate_chunk(*job);
+            },
+            [id, job]() {
+                SimplexTerrainStreamer *self = Object::cast_to<SimplexTerrainStreamer>(ObjectDB::get_instance(id));
+                if (self != nullptr) {
+                    self->_chunk_generated(job);
+                }
+            });
+        it->second.job = job->id;
+        it->second.queued = true;
+        in_flight++;
+    }
+}
+
+void SimplexTerrainStreamer::_generate_chunk(ChunkJob &p_job) {
+    SIMPLEX_TRACE_ZONE("SimplexTerrainStreamer chunk job");
+    const int columns = p_job.columns;
+    const int grid = columns + 2;
+    const float step = p_job.chunk_size / (columns - 1);
+    const Vector2 start(p_job.chunk_size * -0.5f, p_job.chunk_size * -0.5f);
+    ChunkBuffers &buffers = *p_job.buffers;
+
+    // Chunks are the unit of parallelism here, each one is filled on a single worker
+    buffers.heights.resize((size_t)grid * grid);
+    SimplexMonitors::add_samples(2, (uint64_t)grid * grid);
+    p_job.generator.fillRegion2D(buffers.heights.data(), grid, grid, p_job.origin.x + start.x - step,
+        p_job.origin.y + start.y - step, step, step, 0, grid);
+
+    int64_t count = (int64_t)columns * columns;
+    buffers.vertices.resize(count);
+    buffers.normals.resize(count);
+    buffers.tangents.resize(count * 4);
+    Simplex::_write_height_vertices(buffers.heights.data(), columns, columns, start, Vector2(step, step), p_job.amplitude,
+        buffers.vertices.ptrw(), buffers.normals.ptrw(), buffers.tangents.ptrw(), nullptr, 0, columns);
+
+    if (p_job.collision) {
+        // HeightMapShape3D points are one unit apart: the shape is scaled by step, the heights divided by it
+        buffers.collision.resize(count);
+        float *out = buffers.collision.ptrw();
+        float scale = p_job.amplitude / step;
+        for (int z = 0; z < columns; z++) {
+            const float *row = buffers.heights.data() + (size_t)(z + 1) * grid + 1;
+            for (int x = 0; x < columns; x++) {
+                out[z * columns + x] = row[x] * scale;
+            }
+        }
+    }
+}
+
+void SimplexTerrainStreamer::_chunk_generated(const std::shared_ptr<ChunkJob> &p_job) {
+    in_flight--;
+    finished.push_back(p_job);
+}
+
+void SimplexTerrainStreamer::_upload() {
+    SIMPLEX_TRACE_ZONE("SimplexTerrainStreamer::_upload");
+    Time *time = Time::get_singleton();
+    uint64_t start = time->get_ticks_usec();
+    while (!finished.empty()) {
+        std::shared_ptr<ChunkJob> job = finished.front();
+        finished.pop_front();
+
+        std::map<Vector2i, Chunk>::iterator it = chunks.find(job->coord);
+        bool current = it != chunks.end() && job->version == version;
+        if (it != chunks.end() && it->second.job == job->id) {
+            it->second.job = 0;
+            it->second.queued = false;
+        }
+        if (current) {
+            _upload_chunk(it->second, *job);
+        } else if (it != chunks.end()) {
+            // Settings changed while it was generating, queue it again
+            layout_dirty = true;
+        }
+        free_buffers.push_back(std::move(job->buffers));
+
+        if (current && time->get_ticks_usec() - start >= (uint64_t)upload_budget_usec) {
+            break;
+        }
+    }
+}
+
+void SimplexTerrainStreamer::_upload_chunk(Chunk &r_chunk, ChunkJob &p_job) {
+    SIMPLEX_TRACE_ZONE("SimplexTerrainStreamer::_upload_chunk");
+    const int columns = p_job.columns;
+    if (uvs.size() != (int64_t)columns * columns) {
+        uvs.resize((int64_t)columns * columns);
+        Vector2 *uv = uvs.ptrw();
+        for (int z = 0; z < columns; z++) {
+            for (int x = 0; x < columns; x++) {
+                uv[z * columns + x] = Vector2((float)x / (columns - 1), (float)z / (columns - 1));
+            }
+        }
+        indices.resize((int64_t)(columns - 1) * (columns - 1) * 6);
+        Simplex::_write_plane_indices(columns, indices.ptrw(), 1, columns);
+    }
+
+    Vector3 position(p_job.origin.x, 0.0f, p_job.origin.y);
+    if (r_chunk.mesh_instance == nullptr) {
+        r_chunk.mesh.instantiate();
+        r_chunk.mesh_instance = memnew(MeshInstance3D);
+        r_chunk.mesh_instance->set_mesh(r_chunk.mesh);
+        r_chunk.mesh_instance->set_material_override(material);
+        add_child(r_chunk.mesh_instance);
+    }
+    r_chunk.mesh_instance->set_position(position);
+
+    // The arrays are copied into the mesh buffers, after which the job's arrays are free to reuse
+    {
+        Array arrays;
+        arrays.resize(Mesh::ARRAY_MAX);
+        arrays[Mesh::ARRAY_VERTEX] = p_job.buffers->vertices;
+        arrays[Mesh::ARRAY_NORMAL] = p_job.buffers->normals;
+        arrays[Mesh::ARRAY_TANGENT] = p_job.buffers->tangents;
+        arrays[Mesh::ARRAY_TEX_UV] = uvs;
+        arrays[Mesh::ARRAY_INDEX] = indices;
+        r_chunk.mesh->clear_surfaces();
+        r_chunk.mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    }
+
+    if (p_job.collision) {
+        if (r_chunk.body == nullptr) {
+            r_chunk.shape.instantiate();
+            r_chunk.collision_shape = memnew(CollisionShape3D);
+            r_chunk.collision_shape->set_shape(r_chunk.shape);
+            r_chunk.body = memnew(StaticBody3D);
+            r_chunk.body->add_child(r_chunk.collision_shape);
+            add_child(r_chunk.body);
+        }
+        float spacing = p_job.chunk_size / (columns - 1);
+        r_chunk.shape->set_map_width(columns);
+        r_chunk.shape->set_map_depth(columns);
+        // The shape keeps a reference to the array, so give it away: a worker reusing these
+        // buffers would otherwise copy it on its first write. The next chunk allocates a new one.
+        r_chunk.shape->set_map_data(p_job.buffers->collision);
+        p_job.buffers->collision = PackedFloat32Array();
+        r_chunk.collision_shape->set_scale(Vector3(spacing, spacing, spacing));
+        r_chunk.body->set_position(position);
+    } else if (r_chunk.body != nullptr) {
+        r_chunk.body->queue_free();
+        r_chunk.body = nullptr;
+        r_chunk.collision_shape = nullptr;
+        r_chunk.shape.unref();
+    }
+    r_chunk.version = p_job.version;
+}
+
+void SimplexTerrainStreamer::_unload(std::map<Vector2i, Chunk>::iterator p_chunk) {
+    Chunk &chunk = p_chunk->second;
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    // A job that already started finishes normally and is dropped in _upload()
+    if (chunk.queued && scheduler != nullptr && scheduler->cancel(chunk.job)) {
+        in_flight--;
+    }
+    if (chunk.mesh_instance != nullptr) {
+        chunk.mesh_instance->queue_free();
+    }
+    if (chunk.body != nullptr) {
+        chunk.body->queue_free();
+    }
+    chunks.erase(p_chunk);
+}
+
+void SimplexTerrainStreamer::_clear() {
+    while (!chunks.empty()) {
+        _unload(chunks.begin());
+    }
+    pending.clear();
+    for (const std::shared_ptr<ChunkJob> &job : finished) {
+        free_buffers.push_back(std::move(job->buffers));
+    }
+    finished.clear();
+    layout_dirty = true;
+}
+
+void SimplexTerrainStreamer::set_noise(const Ref<Simplex> &p_noise) {
+    if (noise == p_noise) {
+        return;
+    }
+    if (noise.is_valid()) {
+        noise->disconnect("changed", Callable(this, "_on_noise_changed"));
+    }
+    noise = p_noise;
+    if (noise.is_valid()) {
+        noise->connect("changed", Callable(this, "_on_noise_changed"));
+    }
+    _invalidate();
+}
+
+Ref<Simplex> SimplexTerrainStreamer::get_noise() const {
+    return noise;
+}
+
+void SimplexTerrainStreamer::set_target(const NodePath &p_target) {
+    target = p_target;
+}
+
+NodePath SimplexTerrainStreamer::get_target() const {
+    return target;
+}
+
+void SimplexTerrainStreamer::set_chunk_size(float p_size) {
+    ERR_FAIL_COND_MSG(p_size <= 0.0f, "Chunk size must be positive.");
+    if (chunk_size != p_size) {
+        // Chunk coordinates change meaning, nothing on screen can be kept
+        chunk_size = p_size;
+        _clear();
+        _invalidate();
+    }
+}
+
+float SimplexTerrainStreamer::get_chunk_size() const {
+    return chunk_size;
+}
+
+void SimplexTerrainStreamer::set_chunk_subdivisions(int p_subdivisions) {
+    p_subdivisions = CLAMP(p_subdivisions, 0, 254);
+    if (chunk_subdivisions != p_subdivisions) {
+        chunk_subdivisions = p_subdivisions;
+        _invalidate();
+    }
+}
+
+int SimplexTerrainStreamer::get_chunk_subdivisions() const {
+    return chunk_subdivisions;
+}
+
+void SimplexTerrainStreamer::set_amplitude(float p_amplitude) {
+    if (amplitude != p_amplitude) {
+        amplitude = p_amplitude;
+        _invalidate();
+    }
+}
+
+float SimplexTerrainStreamer::get_amplitude() const {
+    return amplitude;
+}
+
+void SimplexTerrainStreamer::set_view_distance(int p_distance) {
+    view_distance = MAX(0, p_distance);
+    layout_dirty = true;
+}
+
+int SimplexTerrainStreamer::get_view_distance() const {
+    return view_distance;
+}
+
+void SimplexTerrainStreamer::set_material(const Ref<Material> &p_material) {
+    material = p_material;
+    for (std::pair<const Vector2i, Chunk> &chunk : chunks) {
+        if (chunk.second.mesh_instance != nullptr) {
+            chunk.second.mesh_instance->set_material_override(material);
+        }
+    }
+}
+
+Ref<Material> SimplexTerrainStreamer::get_material() const {
+    return material;
+}
+
+void SimplexTerrainStreamer::set_generate_collision(bool p_enabled) {
+    if (generate_collision != p_enabled) {
+        generate_collision = p_enabled;
+        _invalidate();
+    }
+}
+
+bool SimplexTerrainStreamer::get_generate_collision() const {
+    return generate_collision;
+}
+
+void SimplexTerrainStreamer::set_upload_budget_usec(int p_usec) {
+    upload_budget_usec = MAX(0, p_usec);
+}
+
+int SimplexTerrainStreamer::get_upload_budget_usec() const {
+    return upload_budget_usec;
+}
+
+int SimplexTerrainStreamer::get_loaded_chunk_count() const {
+    int count = 0;
+    for (const std::pair<const Vector2i, Chunk> &chunk : chunks) {
+        count += chunk.second.mesh_instance != nullptr;
+    }
+    return count;
+}
+
+int SimplexTerrainStreamer::get_pending_chunk_count() const {
+    return (int)pending.size() + in_flight + (int)finished.size();
+}
+
+void SimplexTerrainStreamer::regenerate() {
+    _clear();
+    _invalidate();
+}
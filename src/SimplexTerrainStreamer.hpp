@@ -0,0 +1,143 @@
+#pragma once
+
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/collision_shape3d.hpp>
+#include <godot_cpp/classes/height_map_shape3d.hpp>
+#include <godot_cpp/classes/material.hpp>
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/static_body3d.hpp>
+#include "Simplex.hpp"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+// Square terrain chunks around a target (the current Camera3D by default), built like
+// Simplex::build_height_mesh on the SimplexScheduler workers. The nearest missing chunks
+// are generated first; finished ones are turned into meshes on the main thread within
+// upload_budget_usec per frame, and chunks past view_distance + 1 are freed.
+class SimplexTerrainStreamer : public Node3D {
+    GDCLASS(SimplexTerrainStreamer, Node3D)
+
+    // Per-chunk arrays, handed from chunk to chunk so their memory is reused
+    struct ChunkBuffers {
+        std::vector<float> heights; // raw noise with a one-sample border
+        PackedVector3Array vertices;
+        PackedVector3Array normals;
+        PackedFloat32Array tangents;
+        PackedFloat32Array collision; // handed to the chunk's HeightMapShape3D, so not reused
+    };
+
+    // Everything a worker needs, copied when the chunk is queued
+    struct ChunkJob {
+        uint64_t id = 0;       // scheduler job, set on the main thread after submit
+        Vector2i coord;
+        uint64_t version;
+        SimplexGenerator generator;
+        Vector2 origin;
+        float chunk_size;
+        int columns;
+        float amplitude;
+        bool collision;
+        std::unique_ptr<ChunkBuffers> buffers;
+    };
+
+    struct Chunk {
+        MeshInstance3D *mesh_instance = nullptr;
+        Ref<ArrayMesh> mesh;
+        StaticBody3D *body = nullptr;
+        CollisionShape3D *collision_shape = nullptr;
+        Ref<HeightMapShape3D> shape;
+        uint64_t job = 0;      // scheduler job while generating
+        uint64_t version = 0;  // of the mesh on screen, 0 before the first one
+        bool queued = false;
+    };
+
+    Ref<Simplex> noise;
+    NodePath target;
+    float chunk_size;
+    int chunk_subdivisions;
+    float amplitude;
+    int view_distance;
+    Ref<Material> material;
+    bool generate_collision;
+    int upload_budget_usec;
+
+    std::map<Vector2i, Chunk> chunks;
+    std::vector<Vector2i> pending; // farthest first, so the nearest is popped from the back
+    std::deque<std::shared_ptr<ChunkJob>> finished;
+    std::vector<std::unique_ptr<ChunkBuffers>> free_buffers;
+    Vector2i center_chunk;
+    bool layout_dirty;
+    uint64_t version;
+    int in_flight;
+
+    // Shared by every chunk, which only differ in their heights
+    PackedVector2Array uvs;
+    PackedInt32Array indices;
+
+    void _on_noise_changed();
+    void _invalidate();
+    int _get_columns() const;
+    Vector3 _get_target_position() const;
+    void _update_wanted();
+    void _dispatch();
+    void _upload();
+    void _upload_chunk(Chunk &r_chunk, ChunkJob &p_job);
+    void _chunk_generated(const std::shared_ptr<ChunkJob> &p_job);
+    void _unload(std::map<Vector2i, Chunk>::iterator p_chunk);
+    void _clear();
+    static void _generate_chunk(ChunkJob &p_job);
+
+protected:
+    static void _bind_methods();
+    void _notification(int p_what);
+
+public:
+    SimplexTerrainStreamer();
+    ~SimplexTerrainStreamer();
+
+    void set_noise(const Ref<Simplex> &p_noise);
+    Ref<Simplex> get_noise() const;
+
+    // Node3D the chunks follow; empty follows the current Camera3D, or this node without one
+    void set_target(const NodePath &p_target);
+    NodePath get_target() const;
+
+    // World size of a chunk side, and PlaneMesh-style subdivisions (subdivisions + 1 quads per side)
+    void set_chunk_size(float p_size);
+    float get_chunk_size() const;
+    void set_chunk_subdivisions(int p_subdivisions);
+    int get_chunk_subdivisions() const;
+
+    // Heights are get_noise_2d * amplitude
+    void set_amplitude(float p_amplitude);
+    float get_amplitude() const;
+
+    // Radius in chunks around the target's chunk
+    void set_view_distance(int p_distance);
+    int get_view_distance() const;
+
+    void set_material(const Ref<Material> &p_material);
+    Ref<Material> get_material() const;
+
+    // A StaticBody3D with a HeightMapShape3D per chunk, filled from the same heights
+    void set_generate_collision(bool p_enabled);
+    bool get_generate_collision() const;
+
+    // Main-thread time per frame for turning finished chunks into meshes; at least one per frame
+    void set_upload_budget_usec(int p_usec);
+    int get_upload_budget_usec() const;
+
+    int get_loaded_chunk_count() const;
+    int get_pending_chunk_count() const;
+
+    // Drop every chunk and generate them again
+    void regenerate();
+};
+
+} // namespace godot
@@ -1,6 +1,11 @@
 #include "SimplexTexture.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <memory>
+#include <vector>
 
 namespace godot {
 
@@ -9,20 +14,30 @@ SimplexTexture::SimplexTexture() :
     height(512),
     invert(false),
     in_3d_space(false),
+    offset(0, 0),
     normalize(true),
+    output_format(Image::FORMAT_L8),
     seamless(false),
     seamless_blend_skirt(0.1f),
     as_normal_map(false),
     bump_strength(8.0f),
+    normal_map_packing(NORMAL_MAP_PACKING_RGB),
     generate_mipmaps(true),
+    compress_mode(COMPRESS_MODE_NONE),
+    cache_field(true),
+    generate_async(false),
+    progressive(false),
+    time_slice_usec(0),
+    generation_priority(SimplexScheduler::PRIORITY_INTERACTIVE),
+    generation_id(0),
+    queued_job(0),
+    sliced_task(0),
     current_image_size(0, 0),
     current_image_format(Image::FORMAT_MAX),
-    dirty(true) {
-        UtilityFunctions::print("[SimplexTexture] Constructor");
-
+    dirty(true),
+    update_queued(false) {
         if (noise.is_valid()) {
             noise->connect("changed", Callable(this, "_on_noise_changed"));
-            UtilityFunctions::print("[SimplexTexture] Noise instantiated and connected");
         }
 
         // Generate initial texture
@@ -36,6 +51,9 @@ SimplexTexture::~SimplexTexture() {
     if (color_ramp.is_valid()) {
         color_ramp->disconnect("changed", Callable(this, "_on_color_ramp_changed"));
     }
+    if (remap_curve.is_valid()) {
+        remap_curve->disconnect("changed", Callable(this, "_on_remap_curve_changed"));
+    }
 }
 
 void SimplexTexture::_bind_methods() {
@@ -54,12 +72,22 @@ void SimplexTexture::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_in_3d_space", "enabled"), &SimplexTexture::set_in_3d_space);
     ClassDB::bind_method(D_METHOD("get_in_3d_space"), &SimplexTexture::get_in_3d_space);
     
+    ClassDB::bind_method(D_METHOD("set_offset", "offset"), &SimplexTexture::set_offset);
+    ClassDB::bind_method(D_METHOD("get_offset"), &SimplexTexture::get_offset);
+    ClassDB::bind_method(D_METHOD("get_uv_offset"), &SimplexTexture::get_uv_offset);
+    
     ClassDB::bind_method(D_METHOD("set_normalize", "normalize"), &SimplexTexture::set_normalize);
     ClassDB::bind_method(D_METHOD("get_normalize"), &SimplexTexture::get_normalize);
     
+    ClassDB::bind_method(D_METHOD("set_remap_curve", "curve"), &SimplexTexture::set_remap_curve);
+    ClassDB::bind_method(D_METHOD("get_remap_curve"), &SimplexTexture::get_remap_curve);
+    
     ClassDB::bind_method(D_METHOD("set_seamless", "seamless"), &SimplexTexture::set_seamless);
     ClassDB::bind_method(D_METHOD("get_seamless"), &SimplexTexture::get_seamless);
     
+    ClassDB::bind_method(D_METHOD("set_output_format", "format"), &SimplexTexture::set_output_format);
+    ClassDB::bind_method(D_METHOD("get_output_format"), &SimplexTexture::get_output_format);
+    
     ClassDB::bind_method(D_METHOD("set_seamless_blend_skirt", "skirt"), &SimplexTexture::set_seamless_blend_skirt);
     ClassDB::bind_method(D_METHOD("get_seamless_blend_skirt"), &SimplexTexture::get_seamless_blend_skirt);
     
@@ -72,9 +100,33 @@ void SimplexTexture::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_bump_strength", "strength"), &SimplexTexture::set_bump_strength);
     ClassDB::bind_method(D_METHOD("get_bump_strength"), &SimplexTexture::get_bump_strength);
     
+    ClassDB::bind_method(D_METHOD("set_normal_map_packing", "packing"), &SimplexTexture::set_normal_map_packing);
+    ClassDB::bind_method(D_METHOD("get_normal_map_packing"), &SimplexTexture::get_normal_map_packing);
+    
     ClassDB::bind_method(D_METHOD("set_generate_mipmaps", "enabled"), &SimplexTexture::set_generate_mipmaps);
     ClassDB::bind_method(D_METHOD("get_generate_mipmaps"), &SimplexTexture::get_generate_mipmaps);
     
+    ClassDB::bind_method(D_METHOD("set_cache_field", "enabled"), &SimplexTexture::set_cache_field);
+    ClassDB::bind_method(D_METHOD("get_cache_field"), &SimplexTexture::get_cache_field);
+    
+    ClassDB::bind_method(D_METHOD("set_compress_mode", "mode"), &SimplexTexture::set_compress_mode);
+    ClassDB::bind_method(D_METHOD("get_compress_mode"), &SimplexTexture::get_compress_mode);
+    
+    ClassDB::bind_method(D_METHOD("set_generate_async", "enabled"), &SimplexTexture::set_generate_async);
+    ClassDB::bind_method(D_METHOD("get_generate_async"), &SimplexTexture::get_generate_async);
+    
+    ClassDB::bind_method(D_METHOD("set_progressive", "enabled"), &SimplexTexture::set_progressive);
+    ClassDB::bind_method(D_METHOD("get_progressive"), &SimplexTexture::get_progressive);
+    
+    ClassDB::bind_method(D_METHOD("set_time_slice_usec", "usec"), &SimplexTexture::set_time_slice_usec);
+    ClassDB::bind_method(D_METHOD("get_time_slice_usec"), &SimplexTexture::get_time_slice_usec);
+    
+    ClassDB::bind_method(D_METHOD("set_generation_priority", "priority"), &SimplexTexture::set_generation_priority);
+    ClassDB::bind_method(D_METHOD("get_generation_priority"), &SimplexTexture::get_generation_priority);
+    
+    ClassDB::bind_method(D_METHOD("is_generation_pending"), &SimplexTexture::is_generation_pending);
+    ClassDB::bind_method(D_METHOD("get_last_generation_stats"), &SimplexTexture::get_last_generation_stats);
+    
     ClassDB::bind_method(D_METHOD("regenerate"), &SimplexTexture::regenerate);
     ClassDB::bind_method(D_METHOD("mark_dirty"), &SimplexTexture::mark_dirty);
     
@@ -82,7 +134,18 @@ void SimplexTexture::_bind_methods() {
     
     ClassDB::bind_method(D_METHOD("_on_noise_changed"), &SimplexTexture::_on_noise_changed);
     ClassDB::bind_method(D_METHOD("_on_color_ramp_changed"), &SimplexTexture::_on_color_ramp_changed);
+    ClassDB::bind_method(D_METHOD("_on_remap_curve_changed"), &SimplexTexture::_on_remap_curve_changed);
     ClassDB::bind_method(D_METHOD("_update_texture"), &SimplexTexture::_update_texture);
+    
+    BIND_ENUM_CONSTANT(NORMAL_MAP_PACKING_RGB);
+    BIND_ENUM_CONSTANT(NORMAL_MAP_PACKING_RGB_HEIGHT);
+    BIND_ENUM_CONSTANT(NORMAL_MAP_PACKING_RG);
+
+    BIND_ENUM_CONSTANT(COMPRESS_MODE_NONE);
+    BIND_ENUM_CONSTANT(COMPRESS_MODE_S3TC);
+    BIND_ENUM_CONSTANT(COMPRESS_MODE_ETC2);
+    BIND_ENUM_CONSTANT(COMPRESS_MODE_BPTC);
+    BIND_ENUM_CONSTANT(COMPRESS_MODE_ASTC);
 }
 
 bool SimplexTexture::_set(const StringName &p_name, const Variant &p_value) {
@@ -98,9 +161,18 @@ bool SimplexTexture::_set(const StringName &p_name, const Variant &p_value) {
     } else if (p_name == StringName("in_3d_space")) {
         set_in_3d_space(p_value);
         return true;
+    } else if (p_name == StringName("offset")) {
+        set_offset(p_value);
+        return true;
     } else if (p_name == StringName("normalize")) {
         set_normalize(p_value);
         return true;
+    } else if (p_name == StringName("remap_curve")) {
+        set_remap_curve(p_value);
+        return true;
+    } else if (p_name == StringName("output_format")) {
+        set_output_format((Image::Format)p_value.operator int64_t());
+        return true;
     } else if (p_name == StringName("seamless")) {
         set_seamless(p_value);
         return true;
@@ -116,9 +188,30 @@ bool SimplexTexture::_set(const StringName &p_name, const Variant &p_value) {
     } else if (p_name == StringName("bump_strength")) {
         set_bump_strength(p_value);
         return true;
+    } else if (p_name == StringName("normal_map_packing")) {
+        set_normal_map_packing((NormalMapPacking)p_value.operator int64_t());
+        return true;
     } else if (p_name == StringName("generate_mipmaps")) {
         set_generate_mipmaps(p_value);
         return true;
+    } else if (p_name == StringName("compress_mode")) {
+        set_compress_mode((CompressMode)p_value.operator int64_t());
+        return true;
+    } else if (p_name == StringName("cache_field")) {
+        set_cache_field(p_value);
+        return true;
+    } else if (p_name == StringName("generate_async")) {
+        set_generate_async(p_value);
+        return true;
+    } else if (p_name == StringName("progressive")) {
+        set_progressive(p_value);
+        return true;
+    } else if (p_name == StringName("time_slice_usec")) {
+        set_time_slice_usec(p_value);
+        return true;
+    } else if (p_name == StringName("generation_priority")) {
+        set_generation_priority((SimplexScheduler::Priority)p_value.operator int64_t());
+        return true;
     } else if (p_name == StringName("noise")) {
         set_noise(p_value);
         return true;
@@ -139,9 +232,18 @@ bool SimplexTexture::_get(const StringName &p_name, Variant &r_ret) const {
     } else if (p_name == StringName("in_3d_space")) {
         r_ret = in_3d_space;
         return true;
+    } else if (p_name == StringName("offset")) {
+        r_ret = offset;
+        return true;
     } else if (p_name == StringName("normalize")) {
         r_ret = normalize;
         return true;
+    } else if (p_name == StringName("remap_curve")) {
+        r_ret = remap_curve;
+        return true;
+    } else if (p_name == StringName("output_format")) {
+        r_ret = (int)output_format;
+        return true;
     } else if (p_name == StringName("seamless")) {
         r_ret = seamless;
         return true;
@@ -157,9 +259,33 @@ bool SimplexTexture::_get(const StringName &p_name, Variant &r_ret) const {
     } else if (p_name == StringName("bump_strength")) {
         r_ret = bump_strength;
         return true;
+    } else if (p_name == StringName("normal_map_packing")) {
+        r_ret = (int)normal_map_packing;
+        return true;
     } else if (p_name == StringName("generate_mipmaps")) {
         r_ret = generate_mipmaps;
         return true;
+    } else if (p_name == StringName("compress_mode")) {
+        r_ret = (int)compress_mode;
+        return true;
+    } else if (p_name == StringName("cache_field")) {
+        r_ret = cache_field;
+        return true;
+    } else if (p_name == StringName("generate_async")) {
+        r_ret = generate_async;
+        return true;
+    } else if (p_name == StringName("progressive")) {
+        r_ret = progressive;
+        return true;
+    } else if (p_name == StringName("time_slice_usec")) {
+        r_ret = time_slice_usec;
+        return true;
+    } else if (p_name == StringName("generation_priority")) {
+        r_ret = (int)generation_priority;
+        return true;
+    } else if (p_name == StringName("last_generation_stats")) {
+        r_ret = get_last_generation_stats();
+        return true;
     } else if (p_name == StringName("noise")) {
         r_ret = noise;
         return true;
@@ -177,8 +303,19 @@ void SimplexTexture::_get_property_list(List<PropertyInfo> *p_list) const {
     p_list->push_back(PropertyInfo(Variant::NIL, "Generation", PROPERTY_HINT_NONE, "generation_", PROPERTY_USAGE_GROUP));
     p_list->push_back(PropertyInfo(Variant::BOOL, "invert"));
     p_list->push_back(PropertyInfo(Variant::BOOL, "in_3d_space"));
+    p_list->push_back(PropertyInfo(Variant::VECTOR2I, "offset", PROPERTY_HINT_NONE, "suffix:px"));
     p_list->push_back(PropertyInfo(Variant::BOOL, "normalize"));
+    p_list->push_back(PropertyInfo(Variant::OBJECT, "remap_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"));
+    p_list->push_back(PropertyInfo(Variant::INT, "output_format", PROPERTY_HINT_ENUM,
+        "L8:" + String::num_int64(Image::FORMAT_L8) + ",RH (Half Float):" + String::num_int64(Image::FORMAT_RH) +
+        ",RF (Float):" + String::num_int64(Image::FORMAT_RF)));
     p_list->push_back(PropertyInfo(Variant::BOOL, "generate_mipmaps"));
+    p_list->push_back(PropertyInfo(Variant::INT, "compress_mode", PROPERTY_HINT_ENUM, "None,S3TC,ETC2,BPTC,ASTC"));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "cache_field"));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "generate_async"));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "progressive"));
+    p_list->push_back(PropertyInfo(Variant::INT, "time_slice_usec", PROPERTY_HINT_RANGE, "0,100000,100,suffix:us"));
+    p_list->push_back(PropertyInfo(Variant::INT, "generation_priority", PROPERTY_HINT_ENUM, "Interactive,Near Camera,Background"));
     
     p_list->push_back(PropertyInfo(Variant::NIL, "Seamless", PROPERTY_HINT_NONE, "seamless_", PROPERTY_USAGE_GROUP));
     p_list->push_back(PropertyInfo(Variant::BOOL, "seamless"));
@@ -190,141 +327,654 @@ void SimplexTexture::_get_property_list(List<PropertyInfo> *p_list) const {
     p_list->push_back(PropertyInfo(Variant::NIL, "Normal Map", PROPERTY_HINT_NONE, "normal_map_", PROPERTY_USAGE_GROUP));
     p_list->push_back(PropertyInfo(Variant::BOOL, "as_normal_map"));
     p_list->push_back(PropertyInfo(Variant::FLOAT, "bump_strength", PROPERTY_HINT_RANGE, "0.1,32.0,0.1"));
+    p_list->push_back(PropertyInfo(Variant::INT, "normal_map_packing", PROPERTY_HINT_ENUM, "RGB,RGB + Height in Alpha,RG (Reconstruct Z)"));
+    
+    p_list->push_back(PropertyInfo(Variant::DICTIONARY, "last_generation_stats", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_READ_ONLY));
 }
 
 void SimplexTexture::_update_texture() {
-    UtilityFunctions::print("[SimplexTexture] _update_texture() called, dirty=", dirty);
-    if (!dirty) {
+    update_queued = false;
+    if (!dirty || noise.is_null()) {
         return;
     }
+    SIMPLEX_TRACE_ZONE("SimplexTexture::_update_texture");
+
+    // Async generation needs a reference to keep the texture alive until the upload, which
+    // is not possible while it is still being constructed.
+    if (time_slice_usec > 0 && get_reference_count() > 0 && SimplexScheduler::get_singleton() != nullptr) {
+        // Like progressive passes, only worth it when the noise field has to be sampled again
+        GenerationParams params = _make_params(false);
+        if (!(field_cache && _field_matches(*field_cache, params, true))) {
+            _start_time_sliced(params);
+            return;
+        }
+    }
+    if (progressive && get_reference_count() > 0 && SimplexScheduler::get_singleton() != nullptr) {
+        // Scrolls and post-processing-only changes are cheap already, the passes are for a new field
+        GenerationParams params = _make_params(true);
+        if (params.offset == Vector2i() && !(field_cache && _field_matches(*field_cache, params, true))) {
+            _queue_progressive(params);
+            return;
+        }
+    }
+    if (generate_async && get_reference_count() > 0) {
+        _queue_generation();
+        return;
+    }
+
+    _generate_now();
+}
 
+void SimplexTexture::_generate_now() {
     if (noise.is_null()) {
-        UtilityFunctions::print("[SimplexTexture] _update_texture: noise is NULL!");
         return;
     }
-    
-    Ref<Image> image;
-    
-    if (seamless) {
-        image = noise->get_seamless_image(width, height, invert, in_3d_space, seamless_blend_skirt, normalize);
+    // Any generation still in flight is now outdated
+    generation_id++;
+    _cancel_queued_generation();
+
+    GenerationParams params = _make_params(false);
+    GenerationResult result;
+    _generate_image(params, result);
+    _apply_result(result);
+}
+
+void SimplexTexture::_queue_generation() {
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    if (scheduler == nullptr) {
+        _generate_now();
+        return;
+    }
+
+    uint64_t id = ++generation_id;
+    _cancel_queued_generation();
+
+    std::shared_ptr<GenerationParams> params = std::make_shared<GenerationParams>(_make_params(true));
+    std::shared_ptr<GenerationResult> result = std::make_shared<GenerationResult>();
+    Ref<SimplexTexture> self(this);
+
+    queued_job = scheduler->submit(generation_priority,
+        [params, result, id]() {
+            SIMPLEX_TRACE_ZONE("SimplexTexture generation job");
+            SIMPLEX_TRACE_VALUE(id);
+            _generate_image(*params, *result);
+        },
+        [self, id, result]() {
+            self->_finish_generation(id, *result);
+        });
+}
+
+void SimplexTexture::_cancel_queued_generation() {
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    if (queued_job != 0 && scheduler != nullptr) {
+        scheduler->cancel(queued_job);
+    }
+    queued_job = 0;
+    // A pass already running on a worker stops at its next band of rows
+    if (progressive_state) {
+        progressive_state->abandoned = true;
+        progressive_state.reset();
+    }
+    if (sliced_task != 0 && scheduler != nullptr) {
+        scheduler->remove_frame_task(sliced_task);
+    }
+    sliced_task = 0;
+    sliced_state.reset();
+}
+
+void SimplexTexture::_finish_generation(uint64_t p_id, GenerationResult &p_result) {
+    // Parameters changed again while this job was running; a newer one is on its way
+    if (p_id != generation_id) {
+        return;
+    }
+    SIMPLEX_TRACE_ZONE("SimplexTexture::_finish_generation");
+    SIMPLEX_TRACE_VALUE(p_id);
+    queued_job = 0;
+    p_result.stats.async = true;
+    _apply_result(p_result);
+}
+
+void SimplexTexture::_queue_progressive(const GenerationParams &p_params) {
+    uint64_t id = ++generation_id;
+    _cancel_queued_generation();
+
+    // Like time slicing, only started after the field lookup missed
+    SimplexMonitors::add_cache_access(SimplexMonitors::CACHE_FIELD, false);
+
+    std::shared_ptr<ProgressiveState> state = std::make_shared<ProgressiveState>();
+    state->params = p_params;
+    state->values.resize((size_t)p_params.width * p_params.height);
+    progressive_state = state;
+
+    // The coarsest pass is 1/64 of the samples: cheap enough to show in the frame of the edit
+    GenerationResult result;
+    state->params.priority = SimplexScheduler::PRIORITY_INTERACTIVE;
+    _generate_pass(*state, PROGRESSIVE_START_STRIDE, result);
+    state->params.priority = p_params.priority;
+    _apply_result(result);
+    _queue_pass(id, state, PROGRESSIVE_START_STRIDE / 2);
+}
+
+void SimplexTexture::_queue_pass(uint64_t p_id, const std::shared_ptr<ProgressiveState> &p_state, int p_stride) {
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    ERR_FAIL_NULL(scheduler);
+    std::shared_ptr<GenerationResult> result = std::make_shared<GenerationResult>();
+    Ref<SimplexTexture> self(this);
+
+    queued_job = scheduler->submit(p_state->params.priority,
+        [p_state, result, p_stride]() {
+            SIMPLEX_TRACE_ZONE("SimplexTexture progressive pass");
+            SIMPLEX_TRACE_VALUE(p_stride);
+            _generate_pass(*p_state, p_stride, *result);
+        },
+        [self, p_id, p_state, p_stride, result]() {
+            self->_finish_pass(p_id, p_state, p_stride, *result);
+        });
+}
+
+void SimplexTexture::_finish_pass(uint64_t p_id, const std::shared_ptr<ProgressiveState> &p_state, int p_stride,
+        GenerationResult &p_result) {
+    // Abandoned passes return without an image
+    if (p_id != generation_id || p_result.image.is_null()) {
+        return;
+    }
+    queued_job = 0;
+    p_result.stats.async = true;
+    _apply_result(p_result);
+    if (p_stride > 1) {
+        _queue_pass(p_id, p_state, p_stride / 2);
     } else {
-        image = noise->get_image(width, height, invert, in_3d_space, normalize);
+        progressive_state.reset();
     }
+}
+
+void SimplexTexture::_generate_pass(ProgressiveState &p_state, int p_stride, GenerationResult &r_result) {
+    SIMPLEX_TRACE_ZONE("SimplexTexture::_generate_pass");
+    const GenerationParams &params = p_state.params;
+    Time *time = Time::get_singleton();
+    GenerationStats &stats = r_result.stats;
+    stats.pixels = (int64_t)params.width * params.height;
+    stats.progressive_stride = p_stride;
+    uint64_t start = time->get_ticks_usec();
 
-    if (image.is_null()) {
-        UtilityFunctions::print("[SimplexTexture] _update_texture: image is NULL!");
+    // Later passes skip the points every coarser pass already sampled
+    bool skip_coarser = p_stride != PROGRESSIVE_START_STRIDE;
+    int columns = (params.width + p_stride - 1) / p_stride;
+    int rows = (params.height + p_stride - 1) / p_stride;
+    stats.noise_pixels = (int64_t)columns * rows;
+    if (skip_coarser) {
+        int coarse = p_stride * 2;
+        stats.noise_pixels -= (int64_t)((params.width + coarse - 1) / coarse) * ((params.height + coarse - 1) / coarse);
+    }
+    SimplexMonitors::add_samples(params.in_3d_space ? 3 : 2, stats.noise_pixels);
+    SimplexScheduler::parallel_for(rows, params.priority, [&](int p_begin, int p_end) {
+        if (p_state.abandoned) {
+            return;
+        }
+        params.generator.fillStrided2D(p_state.values.data(), params.width, params.height, params.seamless,
+            params.in_3d_space, params.seamless_blend_skirt, p_stride, skip_coarser, p_begin, p_end);
+    }, MAX(1, 4096 / columns));
+    if (p_state.abandoned) {
         return;
     }
-    UtilityFunctions::print("[SimplexTexture] _update_texture: image obtained, format=", image->get_format());
-    
-    // Apply color ramp if provided
-    if (color_ramp.is_valid() && color_ramp->get_point_count() > 0) {
-        image->convert(Image::FORMAT_RGBA8);
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                Color pixel = image->get_pixel(x, y);
-                float gray = pixel.r;
-                gray = CLAMP(gray, 0.0f, 1.0f);
-                Color mapped = color_ramp->sample(gray);
-                image->set_pixel(x, y, mapped);
-            }
+    uint64_t stage_end = time->get_ticks_usec();
+    stats.noise_usec = stage_end - start;
+
+    if (p_stride > 1) {
+        // Preview: interpolate the grid to full size, and skip compression, which would
+        // cost more than the pass itself
+        std::vector<float> preview(p_state.values.size());
+        SimplexScheduler::parallel_for(params.height, params.priority, [&](int p_begin, int p_end) {
+            SimplexPost::expandGrid(p_state.values.data(), preview.data(), params.width, params.height, p_stride,
+                p_begin, p_end);
+        }, MAX(1, 16384 / params.width));
+        GenerationParams preview_params = params;
+        preview_params.compress_mode = COMPRESS_MODE_NONE;
+        _post_process(preview_params, preview.data(), r_result);
+    } else {
+        // The last pass completes the field, which becomes the regular cache
+        std::shared_ptr<FieldCache> field = std::make_shared<FieldCache>();
+        field->generator = params.generator;
+        field->width = params.width;
+        field->height = params.height;
+        field->in_3d_space = params.in_3d_space;
+        field->offset = params.offset;
+        field->seamless = params.seamless;
+        field->seamless_blend_skirt = params.seamless_blend_skirt;
+        field->values = std::move(p_state.values);
+        _post_process(params, field->values.data(), r_result);
+        if (params.cache_field) {
+            r_result.field = field;
         }
     }
-    
-    // Convert to normal map if requested
-    if (as_normal_map) {
-        Ref<Image> normal_map = Image::create(width, height, false, Image::FORMAT_RGBA8);
-        Ref<Image> height_map = image;
-        
-        for (int y = 1; y < height - 1; y++) {
-            for (int x = 1; x < width - 1; x++) {
-                float h_center = height_map->get_pixel(x, y).r;
-                float h_right = height_map->get_pixel(x + 1, y).r;
-                float h_left = height_map->get_pixel(x - 1, y).r;
-                float h_down = height_map->get_pixel(x, y + 1).r;
-                float h_up = height_map->get_pixel(x, y - 1).r;
-                
-                float dx = (h_right - h_left) * bump_strength;
-                float dy = (h_down - h_up) * bump_strength;
-                
-                Vector3 normal = Vector3(-dx, -dy, 1.0f);
-                float length = normal.length();
-                if (length > 0.0f) {
-                    normal /= length;
-                }
-                
-                Color normal_color(
-                    (normal.x * 0.5f) + 0.5f,
-                    (normal.y * 0.5f) + 0.5f,
-                    (normal.z * 0.5f) + 0.5f,
-                    1.0f
-                );
-                
-                normal_map->set_pixel(x, y, normal_color);
+    SimplexMonitors::add_generation(time->get_ticks_usec() - start);
+}
+
+void SimplexTexture::_start_time_sliced(const GenerationParams &p_params) {
+    uint64_t id = ++generation_id;
+    _cancel_queued_generation();
+
+    sliced_state = std::make_unique<SlicedState>();
+    sliced_state->params = p_params;
+    std::shared_ptr<FieldCache> field = std::make_shared<FieldCache>();
+    field->generator = p_params.generator;
+    field->width = p_params.width;
+    field->height = p_params.height;
+    field->in_3d_space = p_params.in_3d_space;
+    field->offset = p_params.offset;
+    field->seamless = p_params.seamless;
+    field->seamless_blend_skirt = p_params.seamless_blend_skirt;
+    field->values.resize((size_t)p_params.width * p_params.height);
+    sliced_state->field = field;
+    sliced_state->stats.pixels = (int64_t)p_params.width * p_params.height;
+    sliced_state->stats.noise_pixels = sliced_state->stats.pixels;
+    // _update_texture only starts one after the field lookup missed
+    SimplexMonitors::add_cache_access(SimplexMonitors::CACHE_FIELD, false);
+
+    Ref<SimplexTexture> self(this);
+    sliced_task = SimplexScheduler::get_singleton()->add_frame_task([self, id]() {
+        return self->_step_time_sliced(id);
+    });
+}
+
+bool SimplexTexture::_step_time_sliced(uint64_t p_id) {
+    // Superseded tasks are normally removed, this only guards against a stale step
+    if (p_id != generation_id || !sliced_state) {
+        return false;
+    }
+    SIMPLEX_TRACE_ZONE("SimplexTexture::_step_time_sliced");
+    SlicedState &state = *sliced_state;
+    const GenerationParams &params = state.params;
+    Time *time = Time::get_singleton();
+    uint64_t start = time->get_ticks_usec();
+    state.stats.time_slices++;
+
+    if (state.stage != SlicedState::STAGE_FINISH) {
+        // At least one band per frame, so a budget smaller than a band still makes progress.
+        // The banded stages follow each other within a frame while the budget lasts.
+        int band = MAX(1, 4096 / params.width);
+        do {
+            _step_sliced_band(state, MIN(state.next_row + band, params.height));
+        } while (state.stage != SlicedState::STAGE_FINISH && time->get_ticks_usec() - start < (uint64_t)time_slice_usec);
+        SIMPLEX_TRACE_VALUE(state.next_row);
+        return true;
+    }
+
+    // Mipmaps and compression work on the whole image, so they get a frame of their own
+    Ref<Image> image = Image::create_from_data(params.width, params.height, false, _pixel_format(params), state.data);
+    _finish_image(params, image, state.stats);
+    GenerationResult result;
+    result.image = image;
+    result.stats = state.stats;
+    if (params.cache_field) {
+        result.field = state.field;
+    }
+    const GenerationStats &stats = result.stats;
+    SimplexMonitors::add_generation(stats.noise_usec + stats.normal_map_usec + stats.color_ramp_usec +
+        stats.mipmaps_usec + stats.compress_usec);
+    sliced_task = 0;
+    sliced_state.reset();
+    _apply_result(result);
+    return false;
+}
+
+void SimplexTexture::_step_sliced_band(SlicedState &p_state, int p_end) {
+    const GenerationParams &params = p_state.params;
+    Time *time = Time::get_singleton();
+    uint64_t start = time->get_ticks_usec();
+    int begin = p_state.next_row;
+    size_t first = (size_t)begin * params.width;
+    size_t count = (size_t)(p_end - begin) * params.width;
+    const float *values = p_state.field->values.data();
+
+    switch (p_state.stage) {
+        case SlicedState::STAGE_NOISE:
+            if (params.offset != Vector2i()) {
+                params.generator.fillWrapped2D(p_state.field->values.data(), params.width, params.height, params.in_3d_space,
+                    params.offset.x, params.offset.y + begin, params.offset.x + params.width, params.offset.y + p_end);
+            } else {
+                params.generator.fillStrided2D(p_state.field->values.data(), params.width, params.height, params.seamless,
+                    params.in_3d_space, params.seamless_blend_skirt, 1, false, begin, p_end);
             }
-        }
-        
-        // Handle edges
-        for (int x = 0; x < width; x++) {
-            if (x > 0 && x < width - 1) {
-                normal_map->set_pixel(x, 0, normal_map->get_pixel(x, 1));
-                normal_map->set_pixel(x, height - 1, normal_map->get_pixel(x, height - 2));
+            SimplexMonitors::add_samples(params.in_3d_space ? 3 : 2, (int64_t)count);
+            p_state.stats.noise_usec += time->get_ticks_usec() - start;
+            break;
+
+        case SlicedState::STAGE_HEIGHTS:
+            SimplexPost::toHeights(values + first, p_state.heights.data() + first, count, params.normalize, params.invert,
+                params.remap_curve.get());
+            p_state.stats.normal_map_usec += time->get_ticks_usec() - start;
+            break;
+
+        case SlicedState::STAGE_PIXELS:
+            if (params.as_normal_map) {
+                SimplexPost::NormalLayout layout = (SimplexPost::NormalLayout)params.normal_map_packing;
+                Vector2i seam = _normal_map_seam(params);
+                SimplexPost::toNormalsWrapped(p_state.heights.data(), p_state.data.ptrw(), params.width, params.height,
+                    params.bump_strength, seam.x, seam.y, layout, begin, p_end);
+                p_state.stats.normal_map_usec += time->get_ticks_usec() - start;
+            } else if (!params.color_ramp_lut.is_empty()) {
+                SimplexPost::toRGBA8(values + first, p_state.data.ptrw() + first * 4, count, params.normalize, params.invert,
+                    params.color_ramp_lut.ptr(), params.remap_curve.get());
+                p_state.stats.color_ramp_usec += time->get_ticks_usec() - start;
+            } else {
+                Simplex::encode_pixels(values + first, (int64_t)count, params.invert, params.normalize, params.output_format,
+                    p_state.data.ptrw() + first * Simplex::image_format_pixel_size(params.output_format),
+                    params.remap_curve.get());
+                p_state.stats.noise_usec += time->get_ticks_usec() - start;
             }
-        }
-        for (int y = 0; y < height; y++) {
-            if (y > 0 && y < height - 1) {
-                normal_map->set_pixel(0, y, normal_map->get_pixel(1, y));
-                normal_map->set_pixel(width - 1, y, normal_map->get_pixel(width - 2, y));
+            break;
+
+        case SlicedState::STAGE_FINISH:
+            return;
+    }
+
+    p_state.next_row = p_end;
+    if (p_end < params.height) {
+        return;
+    }
+    // Next stage, sized on entry
+    p_state.next_row = 0;
+    size_t pixels = (size_t)params.width * params.height;
+    if (p_state.stage == SlicedState::STAGE_NOISE && params.as_normal_map) {
+        p_state.stage = SlicedState::STAGE_HEIGHTS;
+        p_state.heights.resize(pixels);
+    } else if (p_state.stage != SlicedState::STAGE_PIXELS) {
+        p_state.stage = SlicedState::STAGE_PIXELS;
+        int pixel_size = params.as_normal_map ?
+            SimplexPost::normalPixelSize((SimplexPost::NormalLayout)params.normal_map_packing) :
+            (!params.color_ramp_lut.is_empty() ? 4 : Simplex::image_format_pixel_size(params.output_format));
+        p_state.data.resize(pixels * pixel_size);
+    } else {
+        p_state.stage = SlicedState::STAGE_FINISH;
+        p_state.heights = std::vector<float>();
+    }
+}
+
+SimplexTexture::GenerationParams SimplexTexture::_make_params(bool p_for_worker) const {
+    GenerationParams params;
+    params.generator = noise->get_generator();
+    params.width = width;
+    params.height = height;
+    params.invert = invert;
+    params.in_3d_space = in_3d_space;
+    params.offset = seamless ? Vector2i() : offset;
+    params.normalize = normalize;
+    params.output_format = output_format;
+    params.seamless = seamless;
+    params.seamless_blend_skirt = seamless_blend_skirt;
+    params.as_normal_map = as_normal_map;
+    params.bump_strength = bump_strength;
+    params.normal_map_packing = normal_map_packing;
+    params.generate_mipmaps = generate_mipmaps;
+    params.compress_mode = compress_mode;
+    params.priority = p_for_worker ? generation_priority : SimplexScheduler::PRIORITY_INTERACTIVE;
+    // A copy-on-write snapshot, so later gradient edits never reach a running worker
+    params.color_ramp_lut = color_ramp_lut;
+    params.remap_curve = remap_table;
+    params.field_cache = field_cache;
+    params.cache_field = cache_field;
+    return params;
+}
+
+bool SimplexTexture::_field_matches(const FieldCache &p_field, const GenerationParams &p_params, bool p_any_offset) {
+    return p_field.width == p_params.width && p_field.height == p_params.height &&
+        p_field.in_3d_space == p_params.in_3d_space && p_field.seamless == p_params.seamless &&
+        (p_any_offset || p_field.offset == p_params.offset) &&
+        (!p_params.seamless || p_field.seamless_blend_skirt == p_params.seamless_blend_skirt) &&
+        p_field.generator.sameParameters(p_params.generator);
+}
+
+int64_t SimplexTexture::_fill_wrapped(const GenerationParams &p_params, float *r_values, const SimplexRect &p_rect) {
+    int rect_width = p_rect.x1 - p_rect.x0;
+    int64_t count = (int64_t)rect_width * (p_rect.y1 - p_rect.y0);
+    if (count <= 0) {
+        return 0;
+    }
+    SimplexMonitors::add_samples(p_params.in_3d_space ? 3 : 2, count);
+    SimplexScheduler::parallel_for(p_rect.y1 - p_rect.y0, p_params.priority, [&](int p_begin, int p_end) {
+        p_params.generator.fillWrapped2D(r_values, p_params.width, p_params.height, p_params.in_3d_space,
+            p_rect.x0, p_rect.y0 + p_begin, p_rect.x1, p_rect.y0 + p_end);
+    }, MAX(1, 4096 / rect_width));
+    return count;
+}
+
+void SimplexTexture::_generate_image(const GenerationParams &p_params, GenerationResult &r_result) {
+    SIMPLEX_TRACE_ZONE("SimplexTexture::_generate_image");
+    Time *time = Time::get_singleton();
+    GenerationStats &stats = r_result.stats;
+    stats.pixels = (int64_t)p_params.width * p_params.height;
+    SIMPLEX_TRACE_VALUE(stats.pixels);
+    uint64_t start = time->get_ticks_usec();
+
+    // Post-processing-only changes start from the field of the previous generation
+    std::shared_ptr<const FieldCache> field = p_params.field_cache;
+    stats.field_reused = field && _field_matches(*field, p_params, false);
+    SimplexMonitors::add_cache_access(SimplexMonitors::CACHE_FIELD, stats.field_reused);
+    if (!stats.field_reused) {
+        std::shared_ptr<FieldCache> fresh = std::make_shared<FieldCache>();
+        fresh->generator = p_params.generator;
+        fresh->width = p_params.width;
+        fresh->height = p_params.height;
+        fresh->in_3d_space = p_params.in_3d_space;
+        fresh->offset = p_params.offset;
+        fresh->seamless = p_params.seamless;
+        fresh->seamless_blend_skirt = p_params.seamless_blend_skirt;
+        if (field && _field_matches(*field, p_params, true)) {
+            // Scrolled: keep the overlap in place and sample only what entered the view
+            SIMPLEX_TRACE_ZONE("SimplexTexture scroll");
+            fresh->values = field->values;
+            SimplexRect rects[2];
+            int count = SimplexGenerator::scrollExposed(p_params.width, p_params.height, field->offset.x, field->offset.y,
+                p_params.offset.x, p_params.offset.y, rects);
+            for (int i = 0; i < count; i++) {
+                stats.noise_pixels += _fill_wrapped(p_params, fresh->values.data(), rects[i]);
             }
+        } else if (p_params.offset != Vector2i()) {
+            fresh->values.resize((size_t)p_params.width * p_params.height);
+            stats.noise_pixels = _fill_wrapped(p_params, fresh->values.data(), SimplexRect{ p_params.offset.x,
+                p_params.offset.y, p_params.offset.x + p_params.width, p_params.offset.y + p_params.height });
+        } else {
+            fresh->values.resize((size_t)p_params.width * p_params.height);
+            Simplex::fill_field_2d(p_params.generator, fresh->values.data(), p_params.width, p_params.height,
+                p_params.seamless, p_params.in_3d_space, p_params.seamless_blend_skirt, p_params.priority);
+            stats.noise_pixels = stats.pixels;
         }
-        
-        if (width > 1 && height > 1) {
-            normal_map->set_pixel(0, 0, normal_map->get_pixel(1, 1));
-            normal_map->set_pixel(width - 1, 0, normal_map->get_pixel(width - 2, 1));
-            normal_map->set_pixel(0, height - 1, normal_map->get_pixel(1, height - 2));
-            normal_map->set_pixel(width - 1, height - 1, normal_map->get_pixel(width - 2, height - 2));
-        }
-        
-        image = normal_map;
+        field = fresh;
     }
 
-    if (generate_mipmaps) {
-        image->generate_mipmaps();
+    uint64_t stage_end = time->get_ticks_usec();
+    stats.noise_usec = stage_end - start;
+
+    _post_process(p_params, field->values.data(), r_result);
+    SimplexMonitors::add_generation(time->get_ticks_usec() - start);
+    if (p_params.cache_field) {
+        r_result.field = field;
+    }
+}
+
+void SimplexTexture::_post_process(const GenerationParams &p_params, const float *p_values, GenerationResult &r_result) {
+    Time *time = Time::get_singleton();
+    GenerationStats &stats = r_result.stats;
+    size_t count = (size_t)p_params.width * p_params.height;
+    uint64_t stage_end = time->get_ticks_usec();
+
+    Ref<Image> image;
+    PackedByteArray data;
+    if (p_params.as_normal_map) {
+        // Normals come straight from the float heights: no 8-bit banding, and the color
+        // ramp is skipped since its output would be replaced anyway.
+        SIMPLEX_TRACE_ZONE("SimplexTexture normal map");
+        std::vector<float> heights(count);
+        SimplexPost::toHeights(p_values, heights.data(), count, p_params.normalize, p_params.invert,
+            p_params.remap_curve.get());
+        SimplexPost::NormalLayout layout = (SimplexPost::NormalLayout)p_params.normal_map_packing;
+        data.resize(count * SimplexPost::normalPixelSize(layout));
+        uint8_t *pixels = data.ptrw();
+        Vector2i seam = _normal_map_seam(p_params);
+        SimplexScheduler::parallel_for(p_params.height, p_params.priority, [&](int p_begin, int p_end) {
+            SimplexPost::toNormalsWrapped(heights.data(), pixels, p_params.width, p_params.height,
+                p_params.bump_strength, seam.x, seam.y, layout, p_begin, p_end);
+        }, MAX(1, 16384 / p_params.width));
+        image = Image::create_from_data(p_params.width, p_params.height, false, _pixel_format(p_params), data);
+        uint64_t now = time->get_ticks_usec();
+        stats.normal_map_usec = now - stage_end;
+        stage_end = now;
+    } else if (!p_params.color_ramp_lut.is_empty()) {
+        // Apply the color ramp, quantizing and mapping in a single pass
+        SIMPLEX_TRACE_ZONE("SimplexTexture color ramp");
+        data.resize(count * 4);
+        SimplexPost::toRGBA8(p_values, data.ptrw(), count, p_params.normalize, p_params.invert,
+            p_params.color_ramp_lut.ptr(), p_params.remap_curve.get());
+        image = Image::create_from_data(p_params.width, p_params.height, false, Image::FORMAT_RGBA8, data);
+        uint64_t now = time->get_ticks_usec();
+        stats.color_ramp_usec = now - stage_end;
+        stage_end = now;
+    } else {
+        image = Simplex::create_image(p_values, p_params.width, p_params.height, p_params.invert, p_params.normalize,
+            p_params.output_format, p_params.remap_curve.get());
+        uint64_t now = time->get_ticks_usec();
+        stats.noise_usec += now - stage_end;
+        stage_end = now;
+    }
+
+    _finish_image(p_params, image, stats);
+    r_result.image = image;
+}
+
+Image::Format SimplexTexture::_pixel_format(const GenerationParams &p_params) {
+    if (p_params.as_normal_map) {
+        return p_params.normal_map_packing == NORMAL_MAP_PACKING_RG ? Image::FORMAT_RG8 : Image::FORMAT_RGBA8;
+    }
+    return p_params.color_ramp_lut.is_empty() ? p_params.output_format : Image::FORMAT_RGBA8;
+}
+
+// Seamless fields are periodic. A scrolled field is stored wrapped, and its view starts at
+// the seam: neighbours are clamped there, as at the borders of an unscrolled texture.
+Vector2i SimplexTexture::_normal_map_seam(const GenerationParams &p_params) {
+    if (p_params.seamless) {
+        return Vector2i(-1, -1);
+    }
+    return Vector2i((int)Math::posmod((int64_t)p_params.offset.x, (int64_t)p_params.width),
+        (int)Math::posmod((int64_t)p_params.offset.y, (int64_t)p_params.height));
+}
+
+// Mipmaps and compression of a finished image, shared by every generation path
+void SimplexTexture::_finish_image(const GenerationParams &p_params, const Ref<Image> &p_image, GenerationStats &r_stats) {
+    uint64_t stage_end = Time::get_singleton()->get_ticks_usec();
+    if (p_params.generate_mipmaps) {
+        SIMPLEX_TRACE_ZONE("SimplexTexture mipmaps");
+        p_image->generate_mipmaps();
+        uint64_t now = Time::get_singleton()->get_ticks_usec();
+        r_stats.mipmaps_usec = now - stage_end;
+        stage_end = now;
+    }
+
+    if (p_params.compress_mode != COMPRESS_MODE_NONE) {
+        SIMPLEX_TRACE_ZONE("SimplexTexture compress");
+        static const Image::CompressMode modes[] = {
+            Image::COMPRESS_MAX, Image::COMPRESS_S3TC, Image::COMPRESS_ETC2, Image::COMPRESS_BPTC, Image::COMPRESS_ASTC,
+        };
+        // Normal sources compress to two channels (z rebuilt by hint_normal), unless the height lives in alpha
+        bool normal_source = p_params.as_normal_map && p_params.normal_map_packing != NORMAL_MAP_PACKING_RGB_HEIGHT;
+        Image::CompressSource source = normal_source ? Image::COMPRESS_SOURCE_NORMAL : Image::COMPRESS_SOURCE_GENERIC;
+        // Leaves the image untouched when it fails, so the texture still gets uploaded
+        r_stats.compressed = p_image->compress(modes[p_params.compress_mode], source) == OK;
+        r_stats.compress_failed = !r_stats.compressed;
+        uint64_t now = Time::get_singleton()->get_ticks_usec();
+        r_stats.compress_usec = now - stage_end;
+    }
+}
+
+void SimplexTexture::_apply_result(GenerationResult &p_result) {
+    ERR_FAIL_COND(p_result.image.is_null());
+    SIMPLEX_TRACE_ZONE("SimplexTexture::_apply_result");
+    Ref<Image> image = p_result.image;
+    GenerationStats &stats = p_result.stats;
+    uint64_t upload_start = Time::get_singleton()->get_ticks_usec();
+    if (stats.compress_failed) {
+        WARN_PRINT_ONCE("SimplexTexture: compress_mode is not supported by this build, the texture is uploaded uncompressed.");
     }
-    
 
     Vector2i new_size = image->get_size();
     Image::Format new_format = image->get_format();
 
     if (new_size == current_image_size && new_format == current_image_format) {
         // Compatible → use update()
-        printf("Updated\n");
         update(image);
+        stats.reallocated = false;
     } else {
-        printf("Initialized\n");
         // Size or format changed → must use set_image()
         set_image(image);
         // Update stored properties
         current_image_size = new_size;
         current_image_format = new_format;
+        stats.reallocated = true;
+    }
+    stats.upload_usec = Time::get_singleton()->get_ticks_usec() - upload_start;
+    last_stats = stats;
+    // A progressive preview leaves the texture dirty, so get_image() still generates the exact image
+    if (stats.progressive_stride == 1) {
+        field_cache = p_result.field;
+        dirty = false;
+        SimplexMonitors::add_regeneration();
     }
-    
-    dirty = false;
     emit_changed();
 }
 
+// Resource edits arrive in bursts (a slider drag, several properties set from a script), so
+// they share one update at the end of the frame instead of regenerating on every signal
+void SimplexTexture::_queue_update() {
+    if (!update_queued) {
+        update_queued = true;
+        call_deferred("_update_texture");
+    }
+}
+
 void SimplexTexture::_on_noise_changed() {
     dirty = true;
     emit_changed();
+    _queue_update();
 }
 
 void SimplexTexture::_on_color_ramp_changed() {
+    _bake_color_ramp_lut();
     dirty = true;
     emit_changed();
+    _queue_update();
+}
+
+void SimplexTexture::_bake_color_ramp_lut() {
+    color_ramp_lut = bake_color_ramp(color_ramp);
+}
+
+PackedByteArray SimplexTexture::bake_color_ramp(const Ref<Gradient> &p_ramp) {
+    PackedByteArray table;
+    if (p_ramp.is_null() || p_ramp->get_point_count() == 0) {
+        return table;
+    }
+
+    // One entry per L8 value: the pixels are quantized to 8 bits before the ramp is applied,
+    // so this reproduces the per-pixel Gradient::sample() exactly.
+    table.resize(256 * 4);
+    uint8_t *lut = table.ptrw();
+    for (int i = 0; i < 256; i++) {
+        Color mapped = p_ramp->sample(i / 255.0f);
+        // Same rounding as Image::set_pixel() on an RGBA8 image
+        lut[i * 4 + 0] = uint8_t(CLAMP(mapped.r * 255.0, 0, 255));
+        lut[i * 4 + 1] = uint8_t(CLAMP(mapped.g * 255.0, 0, 255));
+        lut[i * 4 + 2] = uint8_t(CLAMP(mapped.b * 255.0, 0, 255));
+        lut[i * 4 + 3] = uint8_t(CLAMP(mapped.a * 255.0, 0, 255));
+    }
+    return table;
 }
 
 Ref<Image> SimplexTexture::get_image() const {
-    const_cast<SimplexTexture*>(this)->_update_texture();
+    // Callers expect the current parameters, so never wait for a queued generation here
+    SimplexMonitors::add_cache_access(SimplexMonitors::CACHE_TEXTURE, !dirty);
+    if (dirty) {
+        const_cast<SimplexTexture*>(this)->_generate_now();
+    }
     return ImageTexture::get_image();
 }
 
@@ -402,6 +1052,27 @@ bool SimplexTexture::get_in_3d_space() const {
     return in_3d_space;
 }
 
+void SimplexTexture::set_offset(const Vector2i &p_offset) {
+    if (offset != p_offset) {
+        offset = p_offset;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+Vector2i SimplexTexture::get_offset() const {
+    return offset;
+}
+
+Vector2 SimplexTexture::get_uv_offset() const {
+    if (seamless) {
+        return Vector2();
+    }
+    return Vector2((real_t)Math::posmod((int64_t)offset.x, (int64_t)width) / width,
+        (real_t)Math::posmod((int64_t)offset.y, (int64_t)height) / height);
+}
+
 void SimplexTexture::set_normalize(bool p_normalize) {
     if (normalize != p_normalize) {
         normalize = p_normalize;
@@ -451,9 +1122,10 @@ void SimplexTexture::set_color_ramp(const Ref<Gradient> &p_ramp) {
         if (color_ramp.is_valid()) {
             color_ramp->connect("changed", Callable(this, "_on_color_ramp_changed"));
         }
+        _bake_color_ramp_lut();
         dirty = true;
         emit_changed();
-        call_deferred("_update_texture");
+        _queue_update();
     }
 }
 
@@ -461,6 +1133,47 @@ Ref<Gradient> SimplexTexture::get_color_ramp() const {
     return color_ramp;
 }
 
+void SimplexTexture::set_remap_curve(const Ref<Curve> &p_curve) {
+    if (remap_curve != p_curve) {
+        if (remap_curve.is_valid()) {
+            remap_curve->disconnect("changed", Callable(this, "_on_remap_curve_changed"));
+        }
+        remap_curve = p_curve;
+        if (remap_curve.is_valid()) {
+            remap_curve->connect("changed", Callable(this, "_on_remap_curve_changed"));
+        }
+        remap_table = Simplex::bake_curve(remap_curve);
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+Ref<Curve> SimplexTexture::get_remap_curve() const {
+    return remap_curve;
+}
+
+void SimplexTexture::_on_remap_curve_changed() {
+    remap_table = Simplex::bake_curve(remap_curve);
+    dirty = true;
+    emit_changed();
+    _queue_update();
+}
+
+void SimplexTexture::set_output_format(Image::Format p_format) {
+    ERR_FAIL_COND_MSG(!Simplex::is_supported_image_format(p_format), "Unsupported output format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    if (output_format != p_format) {
+        output_format = p_format;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+Image::Format SimplexTexture::get_output_format() const {
+    return output_format;
+}
+
 void SimplexTexture::set_as_normal_map(bool p_enabled) {
     if (as_normal_map != p_enabled) {
         as_normal_map = p_enabled;
@@ -487,6 +1200,19 @@ float SimplexTexture::get_bump_strength() const {
     return bump_strength;
 }
 
+void SimplexTexture::set_normal_map_packing(NormalMapPacking p_packing) {
+    if (normal_map_packing != p_packing) {
+        normal_map_packing = p_packing;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+SimplexTexture::NormalMapPacking SimplexTexture::get_normal_map_packing() const {
+    return normal_map_packing;
+}
+
 void SimplexTexture::set_generate_mipmaps(bool p_enabled) {
     if (generate_mipmaps != p_enabled) {
         generate_mipmaps = p_enabled;
@@ -500,11 +1226,93 @@ bool SimplexTexture::get_generate_mipmaps() const {
     return generate_mipmaps;
 }
 
+void SimplexTexture::set_cache_field(bool p_enabled) {
+    cache_field = p_enabled;
+    if (!cache_field) {
+        field_cache.reset();
+    }
+}
+
+bool SimplexTexture::get_cache_field() const {
+    return cache_field;
+}
+
+void SimplexTexture::set_compress_mode(CompressMode p_mode) {
+    ERR_FAIL_INDEX(p_mode, COMPRESS_MODE_ASTC + 1);
+    if (compress_mode != p_mode) {
+        compress_mode = p_mode;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+SimplexTexture::CompressMode SimplexTexture::get_compress_mode() const {
+    return compress_mode;
+}
+
 void SimplexTexture::regenerate() {
     dirty = true;
     _update_texture();
 }
 
+void SimplexTexture::set_generate_async(bool p_enabled) {
+    generate_async = p_enabled;
+}
+
+bool SimplexTexture::get_generate_async() const {
+    return generate_async;
+}
+
+void SimplexTexture::set_progressive(bool p_enabled) {
+    progressive = p_enabled;
+}
+
+bool SimplexTexture::get_progressive() const {
+    return progressive;
+}
+
+void SimplexTexture::set_time_slice_usec(int p_usec) {
+    time_slice_usec = MAX(0, p_usec);
+}
+
+int SimplexTexture::get_time_slice_usec() const {
+    return time_slice_usec;
+}
+
+void SimplexTexture::set_generation_priority(SimplexScheduler::Priority p_priority) {
+    generation_priority = p_priority;
+}
+
+SimplexScheduler::Priority SimplexTexture::get_generation_priority() const {
+    return generation_priority;
+}
+
+bool SimplexTexture::is_generation_pending() const {
+    return queued_job != 0 || sliced_task != 0;
+}
+
+Dictionary SimplexTexture::get_last_generation_stats() const {
+    Dictionary stats;
+    stats["noise_usec"] = (int64_t)last_stats.noise_usec;
+    stats["color_ramp_usec"] = (int64_t)last_stats.color_ramp_usec;
+    stats["normal_map_usec"] = (int64_t)last_stats.normal_map_usec;
+    stats["mipmaps_usec"] = (int64_t)last_stats.mipmaps_usec;
+    stats["compress_usec"] = (int64_t)last_stats.compress_usec;
+    stats["upload_usec"] = (int64_t)last_stats.upload_usec;
+    stats["total_usec"] = (int64_t)(last_stats.noise_usec + last_stats.color_ramp_usec + last_stats.normal_map_usec +
+        last_stats.mipmaps_usec + last_stats.compress_usec + last_stats.upload_usec);
+    stats["pixels"] = last_stats.pixels;
+    stats["noise_pixels"] = last_stats.noise_pixels;
+    stats["compressed"] = last_stats.compressed;
+    stats["field_reused"] = last_stats.field_reused;
+    stats["reallocated"] = last_stats.reallocated;
+    stats["async"] = last_stats.async;
+    stats["progressive_stride"] = last_stats.progressive_stride;
+    stats["time_slices"] = last_stats.time_slices;
+    return stats;
+}
+
 void SimplexTexture::mark_dirty() {
     dirty = true;
 }
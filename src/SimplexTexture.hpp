@@ -1,15 +1,35 @@
 #pragma once
 
 #include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/curve.hpp>
 #include <godot_cpp/classes/gradient.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include "Simplex.hpp"
 
+#include <atomic>
+
 namespace godot {
 
 class SimplexTexture : public ImageTexture {
     GDCLASS(SimplexTexture, ImageTexture)
 
+public:
+    // Texel layout of as_normal_map output
+    enum NormalMapPacking {
+        NORMAL_MAP_PACKING_RGB = SimplexPost::NORMAL_RGBA8,               // RGBA8, opaque alpha
+        NORMAL_MAP_PACKING_RGB_HEIGHT = SimplexPost::NORMAL_RGBA8_HEIGHT, // RGBA8, height in alpha
+        NORMAL_MAP_PACKING_RG = SimplexPost::NORMAL_RG8,                  // RG8, z rebuilt in the shader
+    };
+
+    // GPU block compression applied on the generating thread, after the mipmaps
+    enum CompressMode {
+        COMPRESS_MODE_NONE,
+        COMPRESS_MODE_S3TC,
+        COMPRESS_MODE_ETC2,
+        COMPRESS_MODE_BPTC,
+        COMPRESS_MODE_ASTC,
+    };
+
 private:
     // Core noise
     Ref<Simplex> noise;
@@ -19,20 +39,159 @@ private:
     int height;
     bool invert;
     bool in_3d_space;
+    Vector2i offset;
     bool normalize;
+    Ref<Curve> remap_curve;
+    std::shared_ptr<const SimplexCurveTable> remap_table;
+    Image::Format output_format;
     bool seamless;
     float seamless_blend_skirt;
     Ref<Gradient> color_ramp;
+    PackedByteArray color_ramp_lut;
     bool as_normal_map;
     float bump_strength;
+    NormalMapPacking normal_map_packing;
     bool generate_mipmaps;
+    CompressMode compress_mode;
+    bool cache_field;
+    bool generate_async;
+    bool progressive;
+    int time_slice_usec;
+    SimplexScheduler::Priority generation_priority;
     
     bool dirty;
+    bool update_queued;     // a deferred _update_texture() is pending
+    uint64_t generation_id;
+    uint64_t queued_job;
+    uint64_t sliced_task;
     Vector2i current_image_size;
     Image::Format current_image_format;
     
+    void _queue_update();
     void _on_noise_changed();
     void _on_color_ramp_changed();
+    void _bake_color_ramp_lut();
+    void _on_remap_curve_changed();
+
+    // Raw noise field of a generation and what it was generated from. Immutable once built,
+    // so a worker can read it while the main thread swaps in a newer one.
+    struct FieldCache {
+        SimplexGenerator generator;
+        int width;
+        int height;
+        bool in_3d_space;
+        Vector2i offset;
+        bool seamless;
+        float seamless_blend_skirt;
+        std::vector<float> values; // wrapped when offset is not zero, see set_offset()
+    };
+
+    std::shared_ptr<const FieldCache> field_cache;
+
+    // Everything a generation needs, copied so it can run on a worker thread
+    struct GenerationParams {
+        SimplexGenerator generator;
+        int width;
+        int height;
+        bool invert;
+        bool in_3d_space;
+        Vector2i offset;    // always zero for seamless textures
+        bool normalize;
+        std::shared_ptr<const SimplexCurveTable> remap_curve;
+        Image::Format output_format;
+        bool seamless;
+        float seamless_blend_skirt;
+        PackedByteArray color_ramp_lut; // empty when there is no color ramp
+        bool as_normal_map;
+        float bump_strength;
+        NormalMapPacking normal_map_packing;
+        bool generate_mipmaps;
+        CompressMode compress_mode;
+        SimplexScheduler::Priority priority;
+        std::shared_ptr<const FieldCache> field_cache; // reused when it matches, may be null
+        bool cache_field;
+    };
+
+    // Per-stage timings of the last generation, see get_last_generation_stats()
+    struct GenerationStats {
+        uint64_t noise_usec = 0;
+        uint64_t color_ramp_usec = 0;
+        uint64_t normal_map_usec = 0;
+        uint64_t mipmaps_usec = 0;
+        uint64_t compress_usec = 0;
+        uint64_t upload_usec = 0;
+        int64_t pixels = 0;
+        int64_t noise_pixels = 0;     // pixels whose noise was sampled, less than pixels after a scroll
+        bool compressed = false;
+        bool compress_failed = false; // the compressor is missing from this build
+        bool field_reused = false;    // only the post-processing ran
+        int progressive_stride = 1;   // pixel spacing of the samples behind a progressive preview, 1 when final
+        int time_slices = 0;          // frames a time-sliced generation was spread over, 0 otherwise
+        bool reallocated = false;
+        bool async = false;
+    };
+
+    struct GenerationResult {
+        Ref<Image> image;
+        std::shared_ptr<const FieldCache> field; // null unless cache_field is set
+        GenerationStats stats;
+    };
+
+    GenerationStats last_stats;
+
+    // Coarsest pass of a progressive generation, every later pass halves the spacing
+    static const int PROGRESSIVE_START_STRIDE = 8;
+
+    // One progressive generation, shared by its passes. Each pass adds the samples of its
+    // stride to values, so the full field costs the same as a single generation.
+    struct ProgressiveState {
+        GenerationParams params;
+        std::vector<float> values;
+        std::atomic<bool> abandoned{ false };
+    };
+
+    std::shared_ptr<ProgressiveState> progressive_state;
+
+    // A time-sliced generation, stepped by a SimplexScheduler frame task. Every stage but the
+    // last works in bands of rows on the main thread; FINISH (mipmaps, compression) cannot be split.
+    struct SlicedState {
+        enum Stage {
+            STAGE_NOISE,    // the field, into field->values
+            STAGE_HEIGHTS,  // normal maps only: the [0, 1] heights, all needed before the normals
+            STAGE_PIXELS,   // the image bytes, into data
+            STAGE_FINISH,   // Image, mipmaps and compression, in a frame of its own
+        };
+        GenerationParams params;
+        std::shared_ptr<FieldCache> field;
+        Stage stage = STAGE_NOISE;
+        int next_row = 0;
+        std::vector<float> heights;
+        PackedByteArray data;
+        GenerationStats stats;
+    };
+
+    std::unique_ptr<SlicedState> sliced_state;
+
+    GenerationParams _make_params(bool p_for_worker) const;
+    static bool _field_matches(const FieldCache &p_field, const GenerationParams &p_params, bool p_any_offset);
+    static int64_t _fill_wrapped(const GenerationParams &p_params, float *r_values, const SimplexRect &p_rect);
+    static void _generate_image(const GenerationParams &p_params, GenerationResult &r_result);
+    static void _post_process(const GenerationParams &p_params, const float *p_values, GenerationResult &r_result);
+    static Image::Format _pixel_format(const GenerationParams &p_params);
+    static Vector2i _normal_map_seam(const GenerationParams &p_params);
+    static void _finish_image(const GenerationParams &p_params, const Ref<Image> &p_image, GenerationStats &r_stats);
+    static void _step_sliced_band(SlicedState &p_state, int p_end);
+    static void _generate_pass(ProgressiveState &p_state, int p_stride, GenerationResult &r_result);
+    void _apply_result(GenerationResult &p_result);
+    void _generate_now();
+    void _queue_generation();
+    void _cancel_queued_generation();
+    void _finish_generation(uint64_t p_id, GenerationResult &p_result);
+    void _queue_progressive(const GenerationParams &p_params);
+    void _start_time_sliced(const GenerationParams &p_params);
+    bool _step_time_sliced(uint64_t p_id);
+    void _queue_pass(uint64_t p_id, const std::shared_ptr<ProgressiveState> &p_state, int p_stride);
+    void _finish_pass(uint64_t p_id, const std::shared_ptr<ProgressiveState> &p_state, int p_stride, GenerationResult &p_result);
 
 protected:
     static void _bind_methods();
@@ -60,9 +219,31 @@ public:
     void set_in_3d_space(bool p_enabled);
     bool get_in_3d_space() const;
     
+    // Scroll position in pixels: the texture shows the noise starting at this pixel. Only the rows
+    // and columns a change exposes are generated, into a wrapped buffer: pixel (x, y) of the view
+    // lives at texel ((x + offset.x) mod width, (y + offset.y) mod height), so shaders sample at
+    // UV + get_uv_offset() with texture repeat enabled. Normal maps are those of the unscrolled
+    // view, clamped at its edges rather than across the wrap. Ignored by seamless textures,
+    // which scroll with a UV offset alone.
+    void set_offset(const Vector2i &p_offset);
+    Vector2i get_offset() const;
+    
+    // UV shift that undoes the wrapping of offset, in [0, 1)
+    Vector2 get_uv_offset() const;
+    
     void set_normalize(bool p_normalize);
     bool get_normalize() const;
     
+    // Shapes the noise of each pixel like Simplex.remap_curve, before normalize and invert: x is
+    // the noise mapped from [-1, 1] to [0, 1], y the shaped value in [0, 1], scaled back to [-1, 1]
+    void set_remap_curve(const Ref<Curve> &p_curve);
+    Ref<Curve> get_remap_curve() const;
+    
+    // Format of the grayscale output: FORMAT_L8, or FORMAT_RH / FORMAT_RF for high-precision
+    // heightmaps. Color ramps and normal maps always produce their 8-bit formats.
+    void set_output_format(Image::Format p_format);
+    Image::Format get_output_format() const;
+    
     void set_seamless(bool p_seamless);
     bool get_seamless() const;
     
@@ -78,9 +259,51 @@ public:
     void set_bump_strength(float p_strength);
     float get_bump_strength() const;
     
+    void set_normal_map_packing(NormalMapPacking p_packing);
+    NormalMapPacking get_normal_map_packing() const;
+    
     void set_generate_mipmaps(bool p_enabled);
     bool get_generate_mipmaps() const;
     
+    // Falls back to the uncompressed image where Godot was built without the compressor
+    void set_compress_mode(CompressMode p_mode);
+    CompressMode get_compress_mode() const;
+    
+    // Keep the last raw noise field (4 bytes per pixel), so that changing only the
+    // post-processing (invert, normalize, remap_curve, output_format, color_ramp, normal map
+    // settings) skips the noise stage
+    void set_cache_field(bool p_enabled);
+    bool get_cache_field() const;
+    
+    // Generate on the SimplexScheduler workers and upload during a later frame
+    void set_generate_async(bool p_enabled);
+    bool get_generate_async() const;
+    
+    // Show the noise at 1/8, 1/4 and 1/2 resolution while the full field is generated: the
+    // first pass runs right away, the others on the SimplexScheduler workers. Each pass samples
+    // only the pixels the previous ones skipped. get_image() still returns the exact image.
+    void set_progressive(bool p_enabled);
+    bool get_progressive() const;
+    
+    // Generate on the main thread only, a band of rows per frame until time_slice_usec is spent,
+    // and publish the texture once the last row and the post-processing are done. For when the
+    // workers are unavailable or must stay out of the way. The noise, normal map and pixel
+    // encoding are sliced; mipmaps and compression run whole, in the last frame. 0 generates
+    // in one go.
+    void set_time_slice_usec(int p_usec);
+    int get_time_slice_usec() const;
+    
+    void set_generation_priority(SimplexScheduler::Priority p_priority);
+    SimplexScheduler::Priority get_generation_priority() const;
+    
+    bool is_generation_pending() const;
+    
+    // Microseconds per stage, pixel count, whether the image was compressed and the texture reallocated
+    Dictionary get_last_generation_stats() const;
+    
+    // 256-entry RGBA8 table for SimplexPost::toRGBA8, empty without a ramp or points
+    static PackedByteArray bake_color_ramp(const Ref<Gradient> &p_ramp);
+    
     // Public utility methods
     void regenerate();
     void mark_dirty();
@@ -91,4 +314,7 @@ public:
     void _update_texture();
 };
 
-} // namespace godot
\ No newline at end of file
+} // namespace godot
+
+VARIANT_ENUM_CAST(SimplexTexture::NormalMapPacking);
+VARIANT_ENUM_CAST(SimplexTexture::CompressMode);
\ No newline at end of file
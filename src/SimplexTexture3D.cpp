@@ -0,0 +1,631 @@
+#include "SimplexTexture3D.hpp"
+#include "SimplexTexture.hpp"
+#include "SimplexMonitors.hpp"
+#include "lib/SimplexTrace.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <memory>
+#include <vector>
+
+namespace godot {
+
+SimplexTexture3D::SimplexTexture3D() :
+    width(64),
+    height(64),
+    depth(64),
+    invert(false),
+    normalize(true),
+    output_format(Image::FORMAT_L8),
+    seamless(false),
+    seamless_blend_skirt(0.1f),
+    generate_async(false),
+    generation_priority(SimplexScheduler::PRIORITY_INTERACTIVE),
+    dirty(true),
+    update_queued(false),
+    generation_id(0),
+    queued_job(0),
+    current_size(0, 0, 0),
+    current_format(Image::FORMAT_MAX) {
+}
+
+SimplexTexture3D::~SimplexTexture3D() {
+    if (noise.is_valid()) {
+        noise->disconnect("changed", Callable(this, "_on_noise_changed"));
+    }
+    if (color_ramp.is_valid()) {
+        color_ramp->disconnect("changed", Callable(this, "_on_color_ramp_changed"));
+    }
+    if (remap_curve.is_valid()) {
+        remap_curve->disconnect("changed", Callable(this, "_on_remap_curve_changed"));
+    }
+}
+
+void SimplexTexture3D::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_noise", "noise"), &SimplexTexture3D::set_noise);
+    ClassDB::bind_method(D_METHOD("get_noise"), &SimplexTexture3D::get_noise);
+
+    ClassDB::bind_method(D_METHOD("set_width", "width"), &SimplexTexture3D::set_width);
+    ClassDB::bind_method(D_METHOD("get_width"), &SimplexTexture3D::get_width);
+
+    ClassDB::bind_method(D_METHOD("set_height", "height"), &SimplexTexture3D::set_height);
+    ClassDB::bind_method(D_METHOD("get_height"), &SimplexTexture3D::get_height);
+
+    ClassDB::bind_method(D_METHOD("set_depth", "depth"), &SimplexTexture3D::set_depth);
+    ClassDB::bind_method(D_METHOD("get_depth"), &SimplexTexture3D::get_depth);
+
+    ClassDB::bind_method(D_METHOD("set_invert", "invert"), &SimplexTexture3D::set_invert);
+    ClassDB::bind_method(D_METHOD("get_invert"), &SimplexTexture3D::get_invert);
+
+    ClassDB::bind_method(D_METHOD("set_normalize", "normalize"), &SimplexTexture3D::set_normalize);
+    ClassDB::bind_method(D_METHOD("get_normalize"), &SimplexTexture3D::get_normalize);
+
+    ClassDB::bind_method(D_METHOD("set_remap_curve", "curve"), &SimplexTexture3D::set_remap_curve);
+    ClassDB::bind_method(D_METHOD("get_remap_curve"), &SimplexTexture3D::get_remap_curve);
+
+    ClassDB::bind_method(D_METHOD("set_output_format", "format"), &SimplexTexture3D::set_output_format);
+    ClassDB::bind_method(D_METHOD("get_output_format"), &SimplexTexture3D::get_output_format);
+
+    ClassDB::bind_method(D_METHOD("set_seamless", "seamless"), &SimplexTexture3D::set_seamless);
+    ClassDB::bind_method(D_METHOD("get_seamless"), &SimplexTexture3D::get_seamless);
+
+    ClassDB::bind_method(D_METHOD("set_seamless_blend_skirt", "skirt"), &SimplexTexture3D::set_seamless_blend_skirt);
+    ClassDB::bind_method(D_METHOD("get_seamless_blend_skirt"), &SimplexTexture3D::get_seamless_blend_skirt);
+
+    ClassDB::bind_method(D_METHOD("set_color_ramp", "ramp"), &SimplexTexture3D::set_color_ramp);
+    ClassDB::bind_method(D_METHOD("get_color_ramp"), &SimplexTexture3D::get_color_ramp);
+
+    ClassDB::bind_method(D_METHOD("set_generate_async", "enabled"), &SimplexTexture3D::set_generate_async);
+    ClassDB::bind_method(D_METHOD("get_generate_async"), &SimplexTexture3D::get_generate_async);
+
+    ClassDB::bind_method(D_METHOD("set_generation_priority", "priority"), &SimplexTexture3D::set_generation_priority);
+    ClassDB::bind_method(D_METHOD("get_generation_priority"), &SimplexTexture3D::get_generation_priority);
+
+    ClassDB::bind_method(D_METHOD("is_generation_pending"), &SimplexTexture3D::is_generation_pending);
+    ClassDB::bind_method(D_METHOD("get_last_generation_stats"), &SimplexTexture3D::get_last_generation_stats);
+
+    ClassDB::bind_method(D_METHOD("regenerate"), &SimplexTexture3D::regenerate);
+    ClassDB::bind_method(D_METHOD("mark_dirty"), &SimplexTexture3D::mark_dirty);
+    ClassDB::bind_method(D_METHOD("get_data"), &SimplexTexture3D::get_data);
+
+    ClassDB::bind_method(D_METHOD("_on_noise_changed"), &SimplexTexture3D::_on_noise_changed);
+    ClassDB::bind_method(D_METHOD("_on_color_ramp_changed"), &SimplexTexture3D::_on_color_ramp_changed);
+    ClassDB::bind_method(D_METHOD("_on_remap_curve_changed"), &SimplexTexture3D::_on_remap_curve_changed);
+    ClassDB::bind_method(D_METHOD("_update_texture"), &SimplexTexture3D::_update_texture);
+}
+
+bool SimplexTexture3D::_set(const StringName &p_name, const Variant &p_value) {
+    if (p_name == StringName("width")) {
+        set_width(p_value);
+        return true;
+    } else if (p_name == StringName("height")) {
+        set_height(p_value);
+        return true;
+    } else if (p_name == StringName("depth")) {
+        set_depth(p_value);
+        return true;
+    } else if (p_name == StringName("invert")) {
+        set_invert(p_value);
+        return true;
+    } else if (p_name == StringName("normalize")) {
+        set_normalize(p_value);
+        return true;
+    } else if (p_name == StringName("remap_curve")) {
+        set_remap_curve(p_value);
+        return true;
+    } else if (p_name == StringName("output_format")) {
+        set_output_format((Image::Format)p_value.operator int64_t());
+        return true;
+    } else if (p_name == StringName("seamless")) {
+        set_seamless(p_value);
+        return true;
+    } else if (p_name == StringName("seamless_blend_skirt")) {
+        set_seamless_blend_skirt(p_value);
+        return true;
+    } else if (p_name == StringName("color_ramp")) {
+        set_color_ramp(p_value);
+        return true;
+    } else if (p_name == StringName("generate_async")) {
+        set_generate_async(p_value);
+        return true;
+    } else if (p_name == StringName("generation_priority")) {
+        set_generation_priority((SimplexScheduler::Priority)p_value.operator int64_t());
+        return true;
+    } else if (p_name == StringName("noise")) {
+        set_noise(p_value);
+        return true;
+    }
+    return false;
+}
+
+bool SimplexTexture3D::_get(const StringName &p_name, Variant &r_ret) const {
+    if (p_name == StringName("width")) {
+        r_ret = width;
+        return true;
+    } else if (p_name == StringName("height")) {
+        r_ret = height;
+        return true;
+    } else if (p_name == StringName("depth")) {
+        r_ret = depth;
+        return true;
+    } else if (p_name == StringName("invert")) {
+        r_ret = invert;
+        return true;
+    } else if (p_name == StringName("normalize")) {
+        r_ret = normalize;
+        return true;
+    } else if (p_name == StringName("remap_curve")) {
+        r_ret = remap_curve;
+        return true;
+    } else if (p_name == StringName("output_format")) {
+        r_ret = (int)output_format;
+        return true;
+    } else if (p_name == StringName("seamless")) {
+        r_ret = seamless;
+        return true;
+    } else if (p_name == StringName("seamless_blend_skirt")) {
+        r_ret = seamless_blend_skirt;
+        return true;
+    } else if (p_name == StringName("color_ramp")) {
+        r_ret = color_ramp;
+        return true;
+    } else if (p_name == StringName("generate_async")) {
+        r_ret = generate_async;
+        return true;
+    } else if (p_name == StringName("generation_priority")) {
+        r_ret = (int)generation_priority;
+        return true;
+    } else if (p_name == StringName("last_generation_stats")) {
+        r_ret = get_last_generation_stats();
+        return true;
+    } else if (p_name == StringName("noise")) {
+        r_ret = noise;
+        return true;
+    }
+    return false;
+}
+
+void SimplexTexture3D::_get_property_list(List<PropertyInfo> *p_list) const {
+    p_list->push_back(PropertyInfo(Variant::OBJECT, "noise", PROPERTY_HINT_RESOURCE_TYPE, "Simplex"));
+
+    p_list->push_back(PropertyInfo(Variant::NIL, "Size", PROPERTY_HINT_NONE, "size_", PROPERTY_USAGE_GROUP));
+    p_list->push_back(PropertyInfo(Variant::INT, "width", PROPERTY_HINT_RANGE, "1,512,1,or_greater"));
+    p_list->push_back(PropertyInfo(Variant::INT, "height", PROPERTY_HINT_RANGE, "1,512,1,or_greater"));
+    p_list->push_back(PropertyInfo(Variant::INT, "depth", PROPERTY_HINT_RANGE, "1,512,1,or_greater"));
+
+    p_list->push_back(PropertyInfo(Variant::NIL, "Generation", PROPERTY_HINT_NONE, "generation_", PROPERTY_USAGE_GROUP));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "invert"));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "normalize"));
+    p_list->push_back(PropertyInfo(Variant::OBJECT, "remap_curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"));
+    p_list->push_back(PropertyInfo(Variant::INT, "output_format", PROPERTY_HINT_ENUM,
+        "L8:" + String::num_int64(Image::FORMAT_L8) + ",RH (Half Float):" + String::num_int64(Image::FORMAT_RH) +
+        ",RF (Float):" + String::num_int64(Image::FORMAT_RF)));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "generate_async"));
+    p_list->push_back(PropertyInfo(Variant::INT, "generation_priority", PROPERTY_HINT_ENUM, "Interactive,Near Camera,Background"));
+
+    p_list->push_back(PropertyInfo(Variant::NIL, "Seamless", PROPERTY_HINT_NONE, "seamless_", PROPERTY_USAGE_GROUP));
+    p_list->push_back(PropertyInfo(Variant::BOOL, "seamless"));
+    p_list->push_back(PropertyInfo(Variant::FLOAT, "seamless_blend_skirt", PROPERTY_HINT_RANGE, "0.0,0.5,0.01"));
+
+    p_list->push_back(PropertyInfo(Variant::NIL, "Color", PROPERTY_HINT_NONE, "color_", PROPERTY_USAGE_GROUP));
+    p_list->push_back(PropertyInfo(Variant::OBJECT, "color_ramp", PROPERTY_HINT_RESOURCE_TYPE, "Gradient"));
+
+    p_list->push_back(PropertyInfo(Variant::DICTIONARY, "last_generation_stats", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_READ_ONLY));
+}
+
+void SimplexTexture3D::_update_texture() {
+    update_queued = false;
+    if (!dirty || noise.is_null()) {
+        return;
+    }
+    SIMPLEX_TRACE_ZONE("SimplexTexture3D::_update_texture");
+
+    // Same constraint as SimplexTexture: no reference to hold while still being constructed
+    if (generate_async && get_reference_count() > 0) {
+        _queue_generation();
+        return;
+    }
+
+    _generate_now();
+}
+
+void SimplexTexture3D::_generate_now() {
+    if (noise.is_null()) {
+        return;
+    }
+    generation_id++;
+    _cancel_queued_generation();
+
+    GenerationParams params = _make_params(false);
+    GenerationResult result;
+    _generate_slices(params, result);
+    _apply_result(result);
+}
+
+void SimplexTexture3D::_queue_generation() {
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    if (scheduler == nullptr) {
+        _generate_now();
+        return;
+    }
+
+    uint64_t id = ++generation_id;
+    _cancel_queued_generation();
+
+    std::shared_ptr<GenerationParams> params = std::make_shared<GenerationParams>(_make_params(true));
+    std::shared_ptr<GenerationResult> result = std::make_shared<GenerationResult>();
+    Ref<SimplexTexture3D> self(this);
+
+    queued_job = scheduler->submit(generation_priority,
+        [params, result, id]() {
+            SIMPLEX_TRACE_ZONE("SimplexTexture3D generation job");
+            SIMPLEX_TRACE_VALUE(id);
+            _generate_slices(*params, *result);
+        },
+        [self, id, result]() {
+            self->_finish_generation(id, *result);
+        });
+}
+
+void SimplexTexture3D::_cancel_queued_generation() {
+    SimplexScheduler *scheduler = SimplexScheduler::get_singleton();
+    if (queued_job != 0 && scheduler != nullptr) {
+        scheduler->cancel(queued_job);
+    }
+    queued_job = 0;
+}
+
+void SimplexTexture3D::_finish_generation(uint64_t p_id, GenerationResult &p_result) {
+    if (p_id != generation_id) {
+        return;
+    }
+    SIMPLEX_TRACE_ZONE("SimplexTexture3D::_finish_generation");
+    SIMPLEX_TRACE_VALUE(p_id);
+    queued_job = 0;
+    p_result.stats.async = true;
+    _apply_result(p_result);
+}
+
+SimplexTexture3D::GenerationParams SimplexTexture3D::_make_params(bool p_for_worker) const {
+    GenerationParams params;
+    params.generator = noise->get_generator();
+    params.width = width;
+    params.height = height;
+    params.depth = depth;
+    params.invert = invert;
+    params.normalize = normalize;
+    params.remap_curve = remap_table;
+    params.output_format = output_format;
+    params.seamless = seamless;
+    params.seamless_blend_skirt = seamless_blend_skirt;
+    params.color_ramp_lut = color_ramp_lut;
+    params.priority = p_for_worker ? generation_priority : SimplexScheduler::PRIORITY_INTERACTIVE;
+    return params;
+}
+
+void SimplexTexture3D::_generate_slices(const GenerationParams &p_params, GenerationResult &r_result) {
+    SIMPLEX_TRACE_ZONE("SimplexTexture3D::_generate_slices");
+    Time *time = Time::get_singleton();
+    GenerationStats &stats = r_result.stats;
+    size_t slice_size = (size_t)p_params.width * p_params.height;
+    stats.voxels = (int64_t)slice_size * p_params.depth;
+    SIMPLEX_TRACE_VALUE(stats.voxels);
+    uint64_t start = time->get_ticks_usec();
+
+    // The whole volume lives in one buffer; only the per-slice conversion allocates images
+    std::vector<float> values(slice_size * p_params.depth);
+    Simplex::fill_field_3d(p_params.generator, values.data(), p_params.width, p_params.height, p_params.depth,
+        p_params.seamless, p_params.seamless_blend_skirt, p_params.priority);
+
+    uint64_t stage_end = time->get_ticks_usec();
+    stats.noise_usec = stage_end - start;
+
+    bool ramp = !p_params.color_ramp_lut.is_empty();
+    std::vector<Ref<Image>> images(p_params.depth);
+    SimplexScheduler::parallel_for(p_params.depth, p_params.priority, [&](int p_begin, int p_end) {
+        for (int z = p_begin; z < p_end; z++) {
+            const float *slice = values.data() + z * slice_size;
+            if (ramp) {
+                PackedByteArray data;
+                data.resize(slice_size * 4);
+                SimplexPost::toRGBA8(slice, data.ptrw(), slice_size, p_params.normalize, p_params.invert,
+                    p_params.color_ramp_lut.ptr(), p_params.remap_curve.get());
+                images[z] = Image::create_from_data(p_params.width, p_params.height, false, Image::FORMAT_RGBA8, data);
+            } else {
+                images[z] = Simplex::create_image(slice, p_params.width, p_params.height, p_params.invert, p_params.normalize,
+                    p_params.output_format, p_params.remap_curve.get());
+            }
+        }
+    });
+
+    r_result.slices.resize(p_params.depth);
+    for (int z = 0; z < p_params.depth; z++) {
+        r_result.slices[z] = images[z];
+    }
+
+    uint64_t now = time->get_ticks_usec();
+    if (ramp) {
+        stats.color_ramp_usec = now - stage_end;
+    } else {
+        stats.noise_usec += now - stage_end;
+    }
+    SimplexMonitors::add_generation(now - start);
+}
+
+void SimplexTexture3D::_apply_result(GenerationResult &p_result) {
+    ERR_FAIL_COND(p_result.slices.is_empty());
+    SIMPLEX_TRACE_ZONE("SimplexTexture3D::_apply_result");
+    GenerationStats &stats = p_result.stats;
+    uint64_t upload_start = Time::get_singleton()->get_ticks_usec();
+
+    Ref<Image> first = p_result.slices[0];
+    Vector3i new_size(first->get_width(), first->get_height(), p_result.slices.size());
+    Image::Format new_format = first->get_format();
+
+    if (new_size == current_size && new_format == current_format) {
+        update(p_result.slices);
+        stats.reallocated = false;
+    } else {
+        // ImageTexture3D only reallocates through create()
+        Error err = create(new_format, new_size.x, new_size.y, new_size.z, false, p_result.slices);
+        ERR_FAIL_COND_MSG(err != OK, "Could not create the 3D texture.");
+        current_size = new_size;
+        current_format = new_format;
+        stats.reallocated = true;
+    }
+    stats.upload_usec = Time::get_singleton()->get_ticks_usec() - upload_start;
+    last_stats = stats;
+
+    dirty = false;
+    SimplexMonitors::add_regeneration();
+    emit_changed();
+}
+
+// Same coalescing as SimplexTexture: the volume is sampled through its RID, so edits of
+// the noise, ramp or curve have to regenerate it without anyone calling get_data()
+void SimplexTexture3D::_queue_update() {
+    if (!update_queued) {
+        update_queued = true;
+        call_deferred("_update_texture");
+    }
+}
+
+void SimplexTexture3D::_on_noise_changed() {
+    dirty = true;
+    emit_changed();
+    _queue_update();
+}
+
+void SimplexTexture3D::_on_color_ramp_changed() {
+    color_ramp_lut = SimplexTexture::bake_color_ramp(color_ramp);
+    dirty = true;
+    emit_changed();
+    _queue_update();
+}
+
+void SimplexTexture3D::_on_remap_curve_changed() {
+    remap_table = Simplex::bake_curve(remap_curve);
+    dirty = true;
+    emit_changed();
+    _queue_update();
+}
+
+TypedArray<Image> SimplexTexture3D::get_data() const {
+    // Callers expect the current parameters, so never wait for a queued generation here
+    SimplexMonitors::add_cache_access(SimplexMonitors::CACHE_TEXTURE, !dirty);
+    if (dirty) {
+        const_cast<SimplexTexture3D *>(this)->_generate_now();
+    }
+    return ImageTexture3D::get_data();
+}
+
+void SimplexTexture3D::set_noise(const Ref<Simplex> &p_noise) {
+    if (noise != p_noise) {
+        if (noise.is_valid()) {
+            noise->disconnect("changed", Callable(this, "_on_noise_changed"));
+        }
+        noise = p_noise;
+        if (noise.is_valid()) {
+            noise->connect("changed", Callable(this, "_on_noise_changed"));
+        }
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+Ref<Simplex> SimplexTexture3D::get_noise() const {
+    return noise;
+}
+
+void SimplexTexture3D::set_width(int p_width) {
+    p_width = MAX(1, p_width);
+    if (width != p_width) {
+        width = p_width;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+int SimplexTexture3D::get_width() const {
+    return width;
+}
+
+void SimplexTexture3D::set_height(int p_height) {
+    p_height = MAX(1, p_height);
+    if (height != p_height) {
+        height = p_height;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+int SimplexTexture3D::get_height() const {
+    return height;
+}
+
+void SimplexTexture3D::set_depth(int p_depth) {
+    p_depth = MAX(1, p_depth);
+    if (depth != p_depth) {
+        depth = p_depth;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+int SimplexTexture3D::get_depth() const {
+    return depth;
+}
+
+void SimplexTexture3D::set_invert(bool p_invert) {
+    if (invert != p_invert) {
+        invert = p_invert;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+bool SimplexTexture3D::get_invert() const {
+    return invert;
+}
+
+void SimplexTexture3D::set_normalize(bool p_normalize) {
+    if (normalize != p_normalize) {
+        normalize = p_normalize;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+bool SimplexTexture3D::get_normalize() const {
+    return normalize;
+}
+
+void SimplexTexture3D::set_remap_curve(const Ref<Curve> &p_curve) {
+    if (remap_curve != p_curve) {
+        if (remap_curve.is_valid()) {
+            remap_curve->disconnect("changed", Callable(this, "_on_remap_curve_changed"));
+        }
+        remap_curve = p_curve;
+        if (remap_curve.is_valid()) {
+            remap_curve->connect("changed", Callable(this, "_on_remap_curve_changed"));
+        }
+        remap_table = Simplex::bake_curve(remap_curve);
+        dirty = true;
+        emit_changed();
+        _queue_update();
+    }
+}
+
+Ref<Curve> SimplexTexture3D::get_remap_curve() const {
+    return remap_curve;
+}
+
+void SimplexTexture3D::set_output_format(Image::Format p_format) {
+    ERR_FAIL_COND_MSG(!Simplex::is_supported_image_format(p_format), "Unsupported output format, expected FORMAT_L8, FORMAT_RH or FORMAT_RF.");
+    if (output_format != p_format) {
+        output_format = p_format;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+Image::Format SimplexTexture3D::get_output_format() const {
+    return output_format;
+}
+
+void SimplexTexture3D::set_seamless(bool p_seamless) {
+    if (seamless != p_seamless) {
+        seamless = p_seamless;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+bool SimplexTexture3D::get_seamless() const {
+    return seamless;
+}
+
+void SimplexTexture3D::set_seamless_blend_skirt(float p_skirt) {
+    p_skirt = CLAMP(p_skirt, 0.0f, 0.5f);
+    if (seamless_blend_skirt != p_skirt) {
+        seamless_blend_skirt = p_skirt;
+        dirty = true;
+        emit_changed();
+        _update_texture();
+    }
+}
+
+float SimplexTexture3D::get_seamless_blend_skirt() const {
+    return seamless_blend_skirt;
+}
+
+void SimplexTexture3D::set_color_ramp(const Ref<Gradient> &p_ramp) {
+    if (color_ramp != p_ramp) {
+        if (color_ramp.is_valid()) {
+            color_ramp->disconnect("changed", Callable(this, "_on_color_ramp_changed"));
+        }
+        color_ramp = p_ramp;
+        if (color_ramp.is_valid()) {
+            color_ramp->connect("changed", Callable(this, "_on_color_ramp_changed"));
+        }
+        color_ramp_lut = SimplexTexture::bake_color_ramp(color_ramp);
+        dirty = true;
+        emit_changed();
+        _queue_update();
+    }
+}
+
+Ref<Gradient> SimplexTexture3D::get_color_ramp() const {
+    return color_ramp;
+}
+
+void SimplexTexture3D::set_generate_async(bool p_enabled) {
+    generate_async = p_enabled;
+}
+
+bool SimplexTexture3D::get_generate_async() const {
+    return generate_async;
+}
+
+void SimplexTexture3D::set_generation_priority(SimplexScheduler::Priority p_priority) {
+    generation_priority = p_priority;
+}
+
+SimplexScheduler::Priority SimplexTexture3D::get_generation_priority() const {
+    return generation_priority;
+}
+
+bool SimplexTexture3D::is_generation_pending() const {
+    return queued_job != 0;
+}
+
+Dictionary SimplexTexture3D::get_last_generation_stats() const {
+    Dictionary stats;
+    stats["noise_usec"] = (int64_t)last_stats.noise_usec;
+    stats["color_ramp_usec"] = (int64_t)last_stats.color_ramp_usec;
+    stats["upload_usec"] = (int64_t)last_stats.upload_usec;
+    stats["total_usec"] = (int64_t)(last_stats.noise_usec + last_stats.color_ramp_usec + last_stats.upload_usec);
+    stats["voxels"] = last_stats.voxels;
+    stats["reallocated"] = last_stats.reallocated;
+    stats["async"] = last_stats.async;
+    return stats;
+}
+
+void SimplexTexture3D::regenerate() {
+    dirty = true;
+    _update_texture();
+}
+
+void SimplexTexture3D::mark_dirty() {
+    dirty = true;
+}
+
+} // namespace godot
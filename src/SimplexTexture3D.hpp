@@ -0,0 +1,152 @@
+#pragma once
+
+#include <godot_cpp/classes/image_texture3d.hpp>
+#include <godot_cpp/classes/curve.hpp>
+#include <godot_cpp/classes/gradient.hpp>
+#include "Simplex.hpp"
+
+namespace godot {
+
+// Volumetric counterpart of SimplexTexture: the get_image_3d / get_seamless_image_3d field,
+// generated into one buffer and uploaded as an ImageTexture3D (fog, clouds, 3D masks).
+class SimplexTexture3D : public ImageTexture3D {
+    GDCLASS(SimplexTexture3D, ImageTexture3D)
+
+private:
+    Ref<Simplex> noise;
+
+    int width;
+    int height;
+    int depth;
+    bool invert;
+    bool normalize;
+    Ref<Curve> remap_curve;
+    std::shared_ptr<const SimplexCurveTable> remap_table;
+    Image::Format output_format;
+    bool seamless;
+    float seamless_blend_skirt;
+    Ref<Gradient> color_ramp;
+    PackedByteArray color_ramp_lut;
+    bool generate_async;
+    SimplexScheduler::Priority generation_priority;
+
+    bool dirty;
+    bool update_queued;     // a deferred _update_texture() is pending
+    uint64_t generation_id;
+    uint64_t queued_job;
+    Vector3i current_size;
+    Image::Format current_format;
+
+    void _queue_update();
+    void _on_noise_changed();
+    void _on_color_ramp_changed();
+    void _on_remap_curve_changed();
+
+    // Everything a generation needs, copied so it can run on a worker thread
+    struct GenerationParams {
+        SimplexGenerator generator;
+        int width;
+        int height;
+        int depth;
+        bool invert;
+        bool normalize;
+        std::shared_ptr<const SimplexCurveTable> remap_curve;
+        Image::Format output_format;
+        bool seamless;
+        float seamless_blend_skirt;
+        PackedByteArray color_ramp_lut; // empty when there is no color ramp
+        SimplexScheduler::Priority priority;
+    };
+
+    // Per-stage timings of the last generation, see get_last_generation_stats()
+    struct GenerationStats {
+        uint64_t noise_usec = 0;
+        uint64_t color_ramp_usec = 0;
+        uint64_t upload_usec = 0;
+        int64_t voxels = 0;
+        bool reallocated = false;
+        bool async = false;
+    };
+
+    struct GenerationResult {
+        TypedArray<Image> slices;
+        GenerationStats stats;
+    };
+
+    GenerationStats last_stats;
+
+    GenerationParams _make_params(bool p_for_worker) const;
+    static void _generate_slices(const GenerationParams &p_params, GenerationResult &r_result);
+    void _apply_result(GenerationResult &p_result);
+    void _generate_now();
+    void _queue_generation();
+    void _cancel_queued_generation();
+    void _finish_generation(uint64_t p_id, GenerationResult &p_result);
+
+protected:
+    static void _bind_methods();
+    bool _set(const StringName &p_name, const Variant &p_value);
+    bool _get(const StringName &p_name, Variant &r_ret) const;
+    void _get_property_list(List<PropertyInfo> *p_list) const;
+
+public:
+    SimplexTexture3D();
+    ~SimplexTexture3D();
+
+    void set_noise(const Ref<Simplex> &p_noise);
+    Ref<Simplex> get_noise() const;
+
+    void set_width(int p_width);
+    int get_width() const;
+
+    void set_height(int p_height);
+    int get_height() const;
+
+    void set_depth(int p_depth);
+    int get_depth() const;
+
+    void set_invert(bool p_invert);
+    bool get_invert() const;
+
+    void set_normalize(bool p_normalize);
+    bool get_normalize() const;
+
+    // Same as SimplexTexture.remap_curve: shapes the noise before normalize and invert
+    void set_remap_curve(const Ref<Curve> &p_curve);
+    Ref<Curve> get_remap_curve() const;
+
+    // FORMAT_L8, FORMAT_RH or FORMAT_RF; a color ramp always produces RGBA8
+    void set_output_format(Image::Format p_format);
+    Image::Format get_output_format() const;
+
+    void set_seamless(bool p_seamless);
+    bool get_seamless() const;
+
+    void set_seamless_blend_skirt(float p_skirt);
+    float get_seamless_blend_skirt() const;
+
+    void set_color_ramp(const Ref<Gradient> &p_ramp);
+    Ref<Gradient> get_color_ramp() const;
+
+    // Generate on the SimplexScheduler workers and upload during a later frame
+    void set_generate_async(bool p_enabled);
+    bool get_generate_async() const;
+
+    void set_generation_priority(SimplexScheduler::Priority p_priority);
+    SimplexScheduler::Priority get_generation_priority() const;
+
+    bool is_generation_pending() const;
+
+    // Microseconds per stage, voxel count and whether the texture was reallocated
+    Dictionary get_last_generation_stats() const;
+
+    void regenerate();
+    void mark_dirty();
+
+    // Ensure up-to-date slices before returning
+    TypedArray<Image> get_data() const;
+
+    void _update_texture();
+};
+
+} // namespace godot
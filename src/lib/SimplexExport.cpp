@@ -0,0 +1,350 @@
+#include "SimplexExport.h"
+#include "SimplexGenerator.h"
+
+#include <cstring>
+
+namespace {
+    void putLE16(std::vector<uint8_t> &out, uint16_t v) {
+        out.push_back((uint8_t)v);
+        out.push_back((uint8_t)(v >> 8));
+    }
+
+    void putLE32(std::vector<uint8_t> &out, uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back((uint8_t)(v >> (8 * i)));
+        }
+    }
+
+    void putLE64(std::vector<uint8_t> &out, uint64_t v) {
+        for (int i = 0; i < 8; i++) {
+            out.push_back((uint8_t)(v >> (8 * i)));
+        }
+    }
+
+    void putBE32(std::vector<uint8_t> &out, uint32_t v) {
+        for (int i = 3; i >= 0; i--) {
+            out.push_back((uint8_t)(v >> (8 * i)));
+        }
+    }
+
+    void putFloat(std::vector<uint8_t> &out, float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        putLE32(out, bits);
+    }
+
+    void putString(std::vector<uint8_t> &out, const char *s) {
+        out.insert(out.end(), s, s + std::strlen(s) + 1);
+    }
+
+    float clamp01(float h) {
+        return h < 0.0f ? 0.0f : (h > 1.0f ? 1.0f : h);
+    }
+
+    uint16_t toUnorm16(float h) {
+        return (uint16_t)(clamp01(h) * 65535.0f + 0.5f);
+    }
+
+    uint32_t crc32(const uint8_t *data, size_t size) {
+        static const std::vector<uint32_t> table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[n] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    // EXR attribute: name, type, size, value
+    void exrAttribute(std::vector<uint8_t> &out, const char *name, const char *type, const std::vector<uint8_t> &value) {
+        putString(out, name);
+        putString(out, type);
+        putLE32(out, (uint32_t)value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    // Largest payload of a stored deflate block
+    const size_t STORED_BLOCK_MAX = 65535;
+}
+
+const char *SimplexExport::extension(Format format)
+{
+    switch (format) {
+        case FORMAT_PNG16:
+            return "png";
+        case FORMAT_EXR:
+        case FORMAT_EXR_HALF:
+            return "exr";
+        case FORMAT_RAW_R32:
+            return "r32";
+        default:
+            return "r16";
+    }
+}
+
+SimplexExport::PngWriter::PngWriter(int width, int height, int bitDepth, ColorType colorType, Sink sink)
+    : mWidth(width), mHeight(height), mBitDepth(bitDepth), mColorType(colorType), mSink(std::move(sink))
+{
+}
+
+size_t SimplexExport::PngWriter::rowSize() const
+{
+    int channels = mColorType == COLOR_RGBA ? 4 : (mColorType == COLOR_RGB ? 3 : (mColorType == COLOR_GRAY_ALPHA ? 2 : 1));
+    return (size_t)mWidth * channels * (mBitDepth / 8);
+}
+
+bool SimplexExport::PngWriter::emit(const std::vector<uint8_t> &bytes)
+{
+    if (mOk && !bytes.empty()) {
+        mOk = mSink(bytes.data(), bytes.size());
+    }
+    return mOk;
+}
+
+void SimplexExport::PngWriter::chunk(const char *type, const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(size + 12);
+    putBE32(bytes, (uint32_t)size);
+    bytes.insert(bytes.end(), type, type + 4);
+    bytes.insert(bytes.end(), data, data + size);
+    putBE32(bytes, crc32(bytes.data() + 4, size + 4));
+    emit(bytes);
+}
+
+bool SimplexExport::PngWriter::writeRows(const uint8_t *rows, int count)
+{
+    if (!mOk || count < 0 || mRow + count > mHeight || (mBitDepth != 8 && mBitDepth != 16)) {
+        return mOk = false;
+    }
+    if (mRow == 0) {
+        static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        emit(std::vector<uint8_t>(signature, signature + sizeof(signature)));
+
+        std::vector<uint8_t> ihdr;
+        putBE32(ihdr, (uint32_t)mWidth);
+        putBE32(ihdr, (uint32_t)mHeight);
+        ihdr.push_back((uint8_t)mBitDepth);
+        ihdr.push_back((uint8_t)mColorType);
+        ihdr.push_back(0);      // deflate
+        ihdr.push_back(0);      // adaptive filtering, every row uses filter 0
+        ihdr.push_back(0);      // not interlaced
+        chunk("IHDR", ihdr.data(), ihdr.size());
+    }
+
+    // Filter byte 0 then the samples of each row, as one zlib stream across all IDATs
+    size_t size = rowSize();
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)count * (1 + size));
+    for (int y = 0; y < count; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rows + (size_t)y * size, rows + (size_t)(y + 1) * size);
+    }
+    // Adler-32, reduced every 5552 bytes like zlib (the largest run that cannot overflow)
+    for (size_t begin = 0; begin < raw.size(); begin += 5552) {
+        size_t end = begin + 5552 < raw.size() ? begin + 5552 : raw.size();
+        for (size_t i = begin; i < end; i++) {
+            mAdlerA += raw[i];
+            mAdlerB += mAdlerA;
+        }
+        mAdlerA %= 65521;
+        mAdlerB %= 65521;
+    }
+
+    mBuffer.clear();
+    if (mRow == 0) {
+        mBuffer.push_back(0x78);    // zlib header: deflate, 32k window
+        mBuffer.push_back(0x01);
+    }
+    for (size_t offset = 0; offset < raw.size(); offset += STORED_BLOCK_MAX) {
+        size_t block = raw.size() - offset < STORED_BLOCK_MAX ? raw.size() - offset : STORED_BLOCK_MAX;
+        mBuffer.push_back(0);       // stored, not final
+        putLE16(mBuffer, (uint16_t)block);
+        putLE16(mBuffer, (uint16_t)~block);
+        mBuffer.insert(mBuffer.end(), raw.begin() + offset, raw.begin() + offset + block);
+    }
+    chunk("IDAT", mBuffer.data(), mBuffer.size());
+    mRow += count;
+    return mOk;
+}
+
+bool SimplexExport::PngWriter::finish()
+{
+    if (!mOk || mRow != mHeight) {
+        return mOk = false;
+    }
+    // Empty final stored block, then the Adler-32 of the uncompressed data
+    std::vector<uint8_t> tail = { 0x01, 0x00, 0x00, 0xFF, 0xFF };
+    putBE32(tail, (mAdlerB << 16) | mAdlerA);
+    chunk("IDAT", tail.data(), tail.size());
+    chunk("IEND", nullptr, 0);
+    return mOk;
+}
+
+SimplexExport::HeightWriter::HeightWriter(Format format, int width, int height, Sink sink)
+    : mFormat(format), mWidth(width), mHeight(height), mSink(std::move(sink))
+{
+}
+
+bool SimplexExport::HeightWriter::emit(const std::vector<uint8_t> &bytes)
+{
+    if (mOk && !bytes.empty()) {
+        mOk = mSink(bytes.data(), bytes.size());
+    }
+    return mOk;
+}
+
+void SimplexExport::HeightWriter::writeHeader()
+{
+    std::vector<uint8_t> header;
+    if (mFormat == FORMAT_EXR || mFormat == FORMAT_EXR_HALF) {
+        putLE32(header, 20000630);  // magic
+        putLE32(header, 2);         // version 2, single part scanline
+
+        std::vector<uint8_t> value;
+        putString(value, "R");
+        putLE32(value, mFormat == FORMAT_EXR_HALF ? 1 : 2);   // HALF or FLOAT
+        putLE32(value, 0);          // pLinear and reserved
+        putLE32(value, 1);          // x sampling
+        putLE32(value, 1);          // y sampling
+        value.push_back(0);
+        exrAttribute(header, "channels", "chlist", value);
+
+        exrAttribute(header, "compression", "compression", { 0 });
+
+        value.clear();
+        putLE32(value, 0);
+        putLE32(value, 0);
+        putLE32(value, (uint32_t)(mWidth - 1));
+        putLE32(value, (uint32_t)(mHeight - 1));
+        exrAttribute(header, "dataWindow", "box2i", value);
+        exrAttribute(header, "displayWindow", "box2i", value);
+
+        exrAttribute(header, "lineOrder", "lineOrder", { 0 });
+
+        value.clear();
+        putFloat(value, 1.0f);
+        exrAttribute(header, "pixelAspectRatio", "float", value);
+        exrAttribute(header, "screenWindowWidth", "float", value);
+
+        value.clear();
+        putFloat(value, 0.0f);
+        putFloat(value, 0.0f);
+        exrAttribute(header, "screenWindowCenter", "v2f", value);
+        header.push_back(0);
+
+        // Uncompressed scanlines have a fixed size, so the offset table is known upfront
+        uint64_t lineSize = 8 + (uint64_t)mWidth * (mFormat == FORMAT_EXR_HALF ? 2 : 4);
+        mExrDataStart = header.size() + (uint64_t)mHeight * 8;
+        for (int y = 0; y < mHeight; y++) {
+            putLE64(header, mExrDataStart + y * lineSize);
+        }
+        emit(header);
+    }
+}
+
+bool SimplexExport::HeightWriter::writeRows(const float *heights, int count)
+{
+    // An unknown format fails before anything is written
+    if (!mOk || count < 0 || mRow + count > mHeight || mFormat < FORMAT_RAW_R16 || mFormat > FORMAT_EXR_HALF) {
+        return mOk = false;
+    }
+    if (mRow == 0) {
+        writeHeader();
+    }
+    if (mFormat == FORMAT_PNG16) {
+        if (!mPng) {
+            mPng.reset(new PngWriter(mWidth, mHeight, 16, PngWriter::COLOR_GRAY, mSink));
+        }
+        mBuffer.clear();
+        mBuffer.reserve((size_t)count * mWidth * 2);
+        for (size_t i = 0; i < (size_t)count * mWidth; i++) {
+            uint16_t v = toUnorm16(heights[i]);
+            mBuffer.push_back((uint8_t)(v >> 8));
+            mBuffer.push_back((uint8_t)v);
+        }
+        mRow += count;
+        return mOk = mPng->writeRows(mBuffer.data(), count);
+    }
+
+    mBuffer.clear();
+    switch (mFormat) {
+        case FORMAT_RAW_R16:
+            mBuffer.reserve((size_t)count * mWidth * 2);
+            for (size_t i = 0; i < (size_t)count * mWidth; i++) {
+                putLE16(mBuffer, toUnorm16(heights[i]));
+            }
+            break;
+
+        case FORMAT_RAW_R32:
+            mBuffer.reserve((size_t)count * mWidth * 4);
+            for (size_t i = 0; i < (size_t)count * mWidth; i++) {
+                putFloat(mBuffer, clamp01(heights[i]));
+            }
+            break;
+
+        case FORMAT_EXR:
+            mBuffer.reserve((size_t)count * (8 + mWidth * 4));
+            for (int y = 0; y < count; y++) {
+                putLE32(mBuffer, (uint32_t)(mRow + y));
+                putLE32(mBuffer, (uint32_t)mWidth * 4);
+                for (int x = 0; x < mWidth; x++) {
+                    putFloat(mBuffer, clamp01(heights[(size_t)y * mWidth + x]));
+                }
+            }
+            break;
+
+        case FORMAT_EXR_HALF:
+            mBuffer.reserve((size_t)count * (8 + mWidth * 2));
+            for (int y = 0; y < count; y++) {
+                putLE32(mBuffer, (uint32_t)(mRow + y));
+                putLE32(mBuffer, (uint32_t)mWidth * 2);
+                for (int x = 0; x < mWidth; x++) {
+                    putLE16(mBuffer, SimplexPost::toHalf(clamp01(heights[(size_t)y * mWidth + x])));
+                }
+            }
+            break;
+
+        default:
+            return mOk = false;
+    }
+    emit(mBuffer);
+    mRow += count;
+    return mOk;
+}
+
+bool SimplexExport::HeightWriter::finish()
+{
+    if (!mOk || mRow != mHeight) {
+        return mOk = false;
+    }
+    if (mFormat == FORMAT_PNG16) {
+        mOk = mPng->finish();
+    }
+    return mOk;
+}
+
+void SimplexExport::downsample(const float *in, int width, int height, float *out)
+{
+    int outWidth = (width + 1) / 2;
+    int outHeight = (height + 1) / 2;
+    for (int y = 0; y < outHeight; y++) {
+        int y0 = 2 * y;
+        int y1 = y0 + 1 < height ? y0 + 1 : y0;
+        for (int x = 0; x < outWidth; x++) {
+            int x0 = 2 * x;
+            int x1 = x0 + 1 < width ? x0 + 1 : x0;
+            out[(size_t)y * outWidth + x] = 0.25f * (in[(size_t)y0 * width + x0] + in[(size_t)y0 * width + x1] +
+                                                     in[(size_t)y1 * width + x0] + in[(size_t)y1 * width + x1]);
+        }
+    }
+}
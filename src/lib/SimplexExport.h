@@ -0,0 +1,106 @@
+/**
+ * @file    SimplexExport.h
+ * @brief   Streaming heightmap writers: raw R16/R32, 16-bit grayscale PNG and float OpenEXR,
+ *          plus the PNG encoder they share for 8-bit images.
+ *
+ * Heightmaps too large to hold in memory are written band by band: rows arrive top to
+ * bottom and are encoded straight into a byte sink (a FileAccess, a FILE*, ...), so the
+ * caller never needs more than the rows it is producing. Like SimplexGenerator.h this only
+ * depends on the C++ standard library.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace SimplexExport {
+    enum Format {
+        FORMAT_RAW_R16,     ///< headerless little-endian uint16, height * 65535 rounded
+        FORMAT_RAW_R32,     ///< headerless little-endian float
+        FORMAT_PNG16,       ///< 16-bit grayscale PNG, stored (uncompressed) deflate blocks
+        FORMAT_EXR,         ///< single channel "R" float OpenEXR scanline image, uncompressed
+        FORMAT_EXR_HALF,    ///< same with a half channel, the values of an Image::FORMAT_RH texture
+    };
+
+    /// File extension without the dot
+    const char *extension(Format format);
+
+    /// Receives the encoded bytes in file order; returns false to abort (e.g. a full disk)
+    typedef std::function<bool(const uint8_t *data, size_t size)> Sink;
+
+    /**
+     * PNG encoder fed row by row. Samples are stored as deflate "stored" blocks: no
+     * compression, but the output is plain PNG any decoder reads, produced at memory speed.
+     */
+    class PngWriter {
+    public:
+        enum ColorType {
+            COLOR_GRAY = 0,
+            COLOR_RGB = 2,
+            COLOR_GRAY_ALPHA = 4,
+            COLOR_RGBA = 6,
+        };
+
+        /// bitDepth is 8 or 16
+        PngWriter(int width, int height, int bitDepth, ColorType colorType, Sink sink);
+
+        /// Bytes of one row, 16-bit samples are big-endian
+        size_t rowSize() const;
+
+        /// Append count rows of rowSize() bytes, the first call also writes the header
+        bool writeRows(const uint8_t *rows, int count);
+
+        /// Write the trailer; false unless exactly height rows were written
+        bool finish();
+
+    private:
+        bool emit(const std::vector<uint8_t> &bytes);
+        void chunk(const char *type, const uint8_t *data, size_t size);
+
+        int mWidth;
+        int mHeight;
+        int mBitDepth;
+        ColorType mColorType;
+        Sink mSink;
+        int mRow = 0;
+        bool mOk = true;
+        uint32_t mAdlerA = 1;
+        uint32_t mAdlerB = 0;
+        std::vector<uint8_t> mBuffer;
+    };
+
+    class HeightWriter {
+    public:
+        HeightWriter(Format format, int width, int height, Sink sink);
+
+        /**
+         * Append count rows of width heights in [0, 1] (clamped), the first call also
+         * writes the header. Returns false once the sink failed or too many rows arrive.
+         */
+        bool writeRows(const float *heights, int count);
+
+        /// Write the trailer; false unless exactly height rows were written
+        bool finish();
+
+    private:
+        bool emit(const std::vector<uint8_t> &bytes);
+        void writeHeader();
+
+        Format mFormat;
+        int mWidth;
+        int mHeight;
+        Sink mSink;
+        int mRow = 0;
+        bool mOk = true;
+        uint64_t mExrDataStart = 0;
+        std::unique_ptr<PngWriter> mPng;
+        std::vector<uint8_t> mBuffer;
+    };
+
+    /// 2x2 box filter of a width * height block into ceil(width / 2) * ceil(height / 2),
+    /// odd edges average the pixels that exist
+    void downsample(const float *in, int width, int height, float *out);
+}
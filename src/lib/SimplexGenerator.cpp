@@ -0,0 +1,567 @@
+/**
+ * @file    SimplexGenerator.cpp
+ * @brief   Godot-independent noise core: fractal/warp dispatch, batch sampling and grid fill.
+ *
+ * Every function here must produce bit-identical values to the original per-pixel loops of
+ * the Simplex resource, so saved resources keep generating the same images.
+ */
+
+#include "SimplexGenerator.h"
+
+#include <cmath>
+#include <cstring>
+
+/**
+ * Same as Godot's Math::smoothstep, including its is_equal_approx() early out
+ */
+static inline float smoothstep(float from, float to, float s) {
+    float tolerance = 0.00001f * std::fabs(from);
+    if (tolerance < 0.00001f) {
+        tolerance = 0.00001f;
+    }
+    if (from == to || std::fabs(from - to) < tolerance) {
+        return from;
+    }
+    s = (s - from) / (to - from);
+    s = s < 0.0f ? 0.0f : (s > 1.0f ? 1.0f : s);
+    return s * s * (3.0f - 2.0f * s);
+}
+
+bool SimplexGenerator::sameParameters(const SimplexGenerator &other) const
+{
+    const SimplexNoise &a = mNoise;
+    const SimplexNoise &b = other.mNoise;
+    return a.mSeed == b.mSeed && a.mOctaves == b.mOctaves && a.mFrequency == b.mFrequency &&
+           a.mAmplitude == b.mAmplitude && a.mLacunarity == b.mLacunarity && a.mPersistence == b.mPersistence &&
+           a.mPingPongStrength == b.mPingPongStrength && a.mDomainWarpAmplitude == b.mDomainWarpAmplitude &&
+           a.mDomainWarpFractalGain == b.mDomainWarpFractalGain &&
+           a.mDomainWarpFractalLacunarity == b.mDomainWarpFractalLacunarity &&
+           a.mDomainWarpFractalOctaves == b.mDomainWarpFractalOctaves &&
+           a.mDomainWarpFrequency == b.mDomainWarpFrequency && mFractalType == other.mFractalType &&
+           mDomainWarpEnabled == other.mDomainWarpEnabled && mDomainWarpFractalType == other.mDomainWarpFractalType &&
+           mRemapCurve == other.mRemapCurve;
+}
+
+float SimplexGenerator::sample(float x) const
+{
+    return mNoise.fractal(x, mFractalType == FRACTAL_NONE);
+}
+
+float SimplexGenerator::sample(float x, float y) const
+{
+    if (mDomainWarpEnabled)
+        warp(x, y);
+
+    switch (mFractalType) {
+    case FRACTAL_RIDGED:
+        return mNoise.ridged(x, y);
+    case FRACTAL_PING_PONG:
+        return mNoise.pingpong(x, y);
+    default:
+        return mNoise.fractal(x, y, mFractalType == FRACTAL_NONE);
+    }
+}
+
+float SimplexGenerator::sample(float x, float y, float z) const
+{
+    // Same dispatch as 2D. Before the split, get_noise_3d ended in `return fractal(...), type == NONE;`,
+    // so the comma operator returned a constant and 3D images were flat; it also skipped the warp.
+    if (mDomainWarpEnabled)
+        warp(x, y, z);
+
+    switch (mFractalType) {
+    case FRACTAL_RIDGED:
+        return mNoise.ridged(x, y, z);
+    case FRACTAL_PING_PONG:
+        return mNoise.pingpong(x, y, z);
+    default:
+        return mNoise.fractal(x, y, z, mFractalType == FRACTAL_NONE);
+    }
+}
+
+void SimplexGenerator::warp(float &x, float &y) const
+{
+    switch (mDomainWarpFractalType)
+    {
+    case DOMAIN_WARP_FRACTAL_INDEPENDENT:
+        mNoise.independent_domain_warp_fractal(x, y);
+        break;
+    case DOMAIN_WARP_FRACTAL_PROGRESSIVE:
+        mNoise.progressive_domain_warp_fractal(x, y);
+        break;
+    default: // DOMAIN_WARP_FRACTAL_NONE
+        mNoise.single_domain_warp_gradient(mNoise.mDomainWarpAmplitude, x, y, x, y);
+        break;
+    }
+}
+
+void SimplexGenerator::warp(float &x, float &y, float &z) const
+{
+    switch (mDomainWarpFractalType)
+    {
+    case DOMAIN_WARP_FRACTAL_INDEPENDENT:
+        mNoise.independent_domain_warp_fractal(x, y, z);
+        break;
+    case DOMAIN_WARP_FRACTAL_PROGRESSIVE:
+        mNoise.progressive_domain_warp_fractal(x, y, z);
+        break;
+    default: // DOMAIN_WARP_FRACTAL_NONE
+        mNoise.single_domain_warp_gradient(mNoise.mDomainWarpAmplitude, x, y, z, x, y, z);
+        break;
+    }
+}
+
+void SimplexGenerator::shapeValues(float *values, size_t count) const
+{
+    if (!mRemapCurve) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        values[i] = shape(values[i]);
+    }
+}
+
+void SimplexGenerator::sampleBatch2D(const float *xy, float *out, size_t count) const
+{
+    for (size_t i = 0; i < count; i++) {
+        out[i] = sample(xy[2 * i], xy[2 * i + 1]);
+    }
+    shapeValues(out, count);
+}
+
+void SimplexGenerator::sampleBatch3D(const float *xyz, float *out, size_t count) const
+{
+    for (size_t i = 0; i < count; i++) {
+        out[i] = sample(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]);
+    }
+    shapeValues(out, count);
+}
+
+void SimplexGenerator::fillGrid2D(float *out, int width, int /*height*/, bool in3DSpace, int rowBegin, int rowEnd) const
+{
+    fillGrid2DRect(out + (size_t)rowBegin * width, width, in3DSpace, 0, width, rowBegin, rowEnd);
+}
+
+void SimplexGenerator::fillSeamless2D(float *out, int width, int height, bool in3DSpace, float skirt, int rowBegin, int rowEnd) const
+{
+    fillSeamless2DRect(out + (size_t)rowBegin * width, width, width, height, in3DSpace, skirt, 0, width, rowBegin, rowEnd);
+}
+
+void SimplexGenerator::fillTile2D(float *out, int width, int height, bool seamless, bool in3DSpace, float skirt,
+                                  int x0, int y0, int tileWidth, int tileHeight) const
+{
+    if (seamless) {
+        fillSeamless2DRect(out, tileWidth, width, height, in3DSpace, skirt, x0, x0 + tileWidth, y0, y0 + tileHeight);
+    } else {
+        fillGrid2DRect(out, tileWidth, in3DSpace, x0, x0 + tileWidth, y0, y0 + tileHeight);
+    }
+}
+
+void SimplexGenerator::fillStrided2D(float *out, int width, int height, bool seamless, bool in3DSpace, float skirt,
+                                     int stride, bool skipCoarser, int rowBegin, int rowEnd) const
+{
+    for (int row = rowBegin; row < rowEnd; row++) {
+        int y = row * stride;
+        float *line = out + (size_t)y * width;
+        // Rows of the coarser grid already hold every other point
+        bool coarseRow = skipCoarser && row % 2 == 0;
+        int step = coarseRow ? 2 * stride : stride;
+        if (step == 1) {
+            if (seamless) {
+                fillSeamless2DRect(line, width, width, height, in3DSpace, skirt, 0, width, y, y + 1);
+            } else {
+                fillGrid2DRect(line, width, in3DSpace, 0, width, y, y + 1);
+            }
+            continue;
+        }
+        for (int x = coarseRow ? stride : 0; x < width; x += step) {
+            if (seamless) {
+                fillSeamless2DRect(line + x, width, width, height, in3DSpace, skirt, x, x + 1, y, y + 1);
+            } else {
+                fillGrid2DRect(line + x, width, in3DSpace, x, x + 1, y, y + 1);
+            }
+        }
+    }
+}
+
+void SimplexGenerator::fillWrapped2D(float *out, int width, int height, bool in3DSpace, int x0, int y0, int x1, int y1,
+                                     int spacing) const
+{
+    // Floored modulo, the offsets of scrolling images go negative
+    auto wrap = [](int v, int size) {
+        int m = v % size;
+        return m < 0 ? m + size : m;
+    };
+    for (int y = y0; y < y1; y++) {
+        float *row = out + (size_t)wrap(y, height) * width;
+        // At most two runs: up to the right edge of the buffer, then from its left edge
+        int x = x0;
+        while (x < x1) {
+            int column = wrap(x, width);
+            int end = x1 - x < width - column ? x1 : x + (width - column);
+            fillGrid2DRect(row + column, width, in3DSpace, x, end, y, y + 1, spacing);
+            x = end;
+        }
+    }
+}
+
+int SimplexGenerator::scrollExposed(int width, int height, int fromX, int fromY, int toX, int toY, SimplexRect rects[2])
+{
+    int dx = toX - fromX;
+    int dy = toY - fromY;
+    if (dx <= -width || dx >= width || dy <= -height || dy >= height) {
+        rects[0] = { toX, toY, toX + width, toY + height };
+        return 1;
+    }
+    int count = 0;
+    // Rows entering at the top or bottom, across the whole new width
+    if (dy != 0) {
+        rects[count++] = dy > 0 ? SimplexRect{ toX, fromY + height, toX + width, toY + height }
+                                : SimplexRect{ toX, toY, toX + width, fromY };
+    }
+    // Columns entering at the left or right, only on the rows both windows share
+    if (dx != 0) {
+        int y0 = dy > 0 ? toY : fromY;
+        int y1 = dy > 0 ? fromY + height : toY + height;
+        rects[count++] = dx > 0 ? SimplexRect{ fromX + width, y0, toX + width, y1 }
+                                : SimplexRect{ toX, y0, fromX, y1 };
+    }
+    return count;
+}
+
+void SimplexGenerator::fillGrid2DRect(float *out, size_t stride, bool in3DSpace, int x0, int x1, int y0, int y1,
+                                      int spacing) const
+{
+    for (int y = y0; y < y1; y++) {
+        float *row = out + (size_t)(y - y0) * stride;
+        float py = (float)y * spacing;
+        for (int x = x0; x < x1; x++) {
+            float px = (float)x * spacing;
+            // Use x,z plane with y=0 when sampling in 3D space
+            row[x - x0] = in3DSpace ? sample(px, 0.0f, py) : sample(px, py);
+        }
+        shapeValues(row, x1 - x0);
+    }
+}
+
+void SimplexGenerator::fillSeamless2DRect(float *out, size_t stride, int width, int height, bool in3DSpace, float skirt,
+                                          int x0, int x1, int y0, int y1) const
+{
+    float inv_width = 1.0f / (width - 1);
+    float inv_height = 1.0f / (height - 1);
+    skirt = skirt < 0.0f ? 0.0f : (skirt > 0.5f ? 0.5f : skirt);
+
+    for (int y = y0; y < y1; y++) {
+        float *row = out + (size_t)(y - y0) * stride;
+        float ny = y * inv_height;
+
+        // Vertical blend factor: top edge blends with bottom, bottom edge with top
+        float vy = 1.0f;
+        if (ny < skirt) {
+            vy = ny / skirt;
+        } else if (ny > 1.0f - skirt) {
+            vy = (1.0f - ny) / skirt;
+        }
+
+        for (int x = x0; x < x1; x++) {
+            float nx = x * inv_width;
+
+            float vx = 1.0f;
+            if (nx < skirt) {
+                vx = nx / skirt;
+            } else if (nx > 1.0f - skirt) {
+                vx = (1.0f - nx) / skirt;
+            }
+
+            float n;
+            if (in3DSpace) {
+                // 3D seamless using torus (Math_TAU is a double, keep the promotion)
+                float angle_x = nx * 6.2831853071795864769252867666;
+                float angle_y = ny * 6.2831853071795864769252867666;
+                float px = std::cos(angle_x);
+                float pz = std::sin(angle_x);
+                float py = std::cos(angle_y);
+                float pw = std::sin(angle_y);
+
+                float scale = 10.0f;
+                n = sample(px * scale, py * scale, pz * scale) * 0.5f +
+                    sample(py * scale, pz * scale, pw * scale) * 0.5f;
+            } else {
+                // Only the corners that are actually blended get sampled
+                float n_center = sample(nx, ny);
+                if (vx < 1.0f && vy < 1.0f) {
+                    float n_right = sample(nx - 1.0f, ny);
+                    float n_bottom = sample(nx, ny - 1.0f);
+                    float n_bottom_right = sample(nx - 1.0f, ny - 1.0f);
+                    float n_horiz1 = SimplexNoise::Lerp(n_right, n_center, vx);
+                    float n_horiz2 = SimplexNoise::Lerp(n_bottom_right, n_bottom, vx);
+                    n = SimplexNoise::Lerp(n_horiz2, n_horiz1, vy);
+                } else if (vx < 1.0f) {
+                    n = SimplexNoise::Lerp(sample(nx - 1.0f, ny), n_center, vx);
+                } else if (vy < 1.0f) {
+                    n = SimplexNoise::Lerp(sample(nx, ny - 1.0f), n_center, vy);
+                } else {
+                    n = n_center;
+                }
+            }
+            row[x - x0] = n;
+        }
+        shapeValues(row, x1 - x0);
+    }
+}
+
+void SimplexGenerator::fillRegion2D(float *out, int width, int /*height*/, float originX, float originY,
+                                    float stepX, float stepY, int rowBegin, int rowEnd) const
+{
+    for (int y = rowBegin; y < rowEnd; y++) {
+        float *row = out + (size_t)y * width;
+        float py = originY + y * stepY;
+        for (int x = 0; x < width; x++) {
+            row[x] = sample(originX + x * stepX, py);
+        }
+        shapeValues(row, width);
+    }
+}
+
+void SimplexGenerator::fillGrid3D(float *out, int width, int height, int /*depth*/, int sliceBegin, int sliceEnd) const
+{
+    fillGrid3DFrom(out, 0, width, height, sliceBegin, sliceEnd);
+}
+
+void SimplexGenerator::fillSeamless3D(float *out, int width, int height, int depth, float skirt, int sliceBegin, int sliceEnd) const
+{
+    fillSeamless3DFrom(out, 0, width, height, depth, skirt, sliceBegin, sliceEnd);
+}
+
+void SimplexGenerator::fillSlices3D(float *out, int width, int height, int depth, bool seamless, float skirt,
+                                    int sliceBegin, int sliceEnd) const
+{
+    if (seamless) {
+        fillSeamless3DFrom(out, sliceBegin, width, height, depth, skirt, sliceBegin, sliceEnd);
+    } else {
+        fillGrid3DFrom(out, sliceBegin, width, height, sliceBegin, sliceEnd);
+    }
+}
+
+void SimplexGenerator::fillGrid3DFrom(float *out, int outSlice, int width, int height, int sliceBegin, int sliceEnd) const
+{
+    for (int z = sliceBegin; z < sliceEnd; z++) {
+        float *slice = out + (size_t)(z - outSlice) * width * height;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                slice[(size_t)y * width + x] = sample((float)x, (float)y, (float)z);
+            }
+        }
+        shapeValues(slice, (size_t)width * height);
+    }
+}
+
+void SimplexGenerator::fillSeamless3DFrom(float *out, int outSlice, int width, int height, int depth, float skirt,
+                                          int sliceBegin, int sliceEnd) const
+{
+    float scale_x = 1.0f / (width - 1);
+    float scale_y = 1.0f / (height - 1);
+    float scale_z = 1.0f / (depth - 1);
+    float blend_start = skirt;
+    float blend_end = 1.0f - skirt;
+
+    for (int z = sliceBegin; z < sliceEnd; z++) {
+        float *slice = out + (size_t)(z - outSlice) * width * height;
+        float nz = z * scale_z;
+
+        float wz = 1.0f;
+        if (nz < blend_start) {
+            wz = smoothstep(0.0f, blend_start, nz);
+        } else if (nz > blend_end) {
+            wz = 1.0f - smoothstep(blend_end, 1.0f, nz);
+        }
+
+        for (int y = 0; y < height; y++) {
+            float ny = y * scale_y;
+
+            float wy = 1.0f;
+            if (ny < blend_start) {
+                wy = smoothstep(0.0f, blend_start, ny);
+            } else if (ny > blend_end) {
+                wy = 1.0f - smoothstep(blend_end, 1.0f, ny);
+            }
+
+            for (int x = 0; x < width; x++) {
+                float nx = x * scale_x;
+
+                // For 3D seamless, we need to sample 8 corners and blend
+                float n000 = sample(nx, ny, nz);
+                float n100 = sample(nx - 1.0f, ny, nz);
+                float n010 = sample(nx, ny - 1.0f, nz);
+                float n110 = sample(nx - 1.0f, ny - 1.0f, nz);
+                float n001 = sample(nx, ny, nz - 1.0f);
+                float n101 = sample(nx - 1.0f, ny, nz - 1.0f);
+                float n011 = sample(nx, ny - 1.0f, nz - 1.0f);
+                float n111 = sample(nx - 1.0f, ny - 1.0f, nz - 1.0f);
+
+                float wx = 1.0f;
+                if (nx < blend_start) {
+                    wx = smoothstep(0.0f, blend_start, nx);
+                } else if (nx > blend_end) {
+                    wx = 1.0f - smoothstep(blend_end, 1.0f, nx);
+                }
+
+                // Trilinear interpolation
+                float n0 = SimplexNoise::Lerp(SimplexNoise::Lerp(n000, n100, wx), SimplexNoise::Lerp(n010, n110, wx), wy);
+                float n1 = SimplexNoise::Lerp(SimplexNoise::Lerp(n001, n101, wx), SimplexNoise::Lerp(n011, n111, wx), wy);
+                slice[(size_t)y * width + x] = SimplexNoise::Lerp(n0, n1, wz);
+            }
+        }
+        shapeValues(slice, (size_t)width * height);
+    }
+}
+
+void SimplexPost::toL8(const float *in, uint8_t *out, size_t count, bool normalize, bool invert,
+                       const SimplexCurveTable *curve)
+{
+    if (curve != nullptr) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = toByte(remap(in[i], normalize, invert, curve));
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        out[i] = toByte(remap(in[i], normalize, invert));
+    }
+}
+
+void SimplexPost::toRGBA8(const float *in, uint8_t *out, size_t count, bool normalize, bool invert, const uint8_t *lut,
+                          const SimplexCurveTable *curve)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *color = lut + 4 * toByte(remap(in[i], normalize, invert, curve));
+        out[4 * i + 0] = color[0];
+        out[4 * i + 1] = color[1];
+        out[4 * i + 2] = color[2];
+        out[4 * i + 3] = color[3];
+    }
+}
+
+void SimplexPost::toHeights(const float *in, float *out, size_t count, bool normalize, bool invert,
+                            const SimplexCurveTable *curve)
+{
+    for (size_t i = 0; i < count; i++) {
+        out[i] = remap(in[i], normalize, invert, curve);
+    }
+}
+
+uint16_t SimplexPost::toHalf(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t biased = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (biased == 0xFF) {
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0); // inf, quiet nan
+    }
+    int exponent = (int)biased - 127 + 15;
+    if (exponent >= 31) {
+        return sign | 0x7C00; // overflow to inf
+    }
+
+    uint32_t half;
+    uint32_t remainder;
+    uint32_t halfway;
+    if (exponent <= 0) {
+        // Subnormal half: shift the mantissa, implicit bit included, below the smallest exponent
+        if (exponent < -10) {
+            return sign;
+        }
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    } else {
+        half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+        remainder = mantissa & 0x1FFF;
+        halfway = 0x1000;
+    }
+    // A carry out of the mantissa correctly bumps the exponent
+    if (remainder > halfway || (remainder == halfway && (half & 1))) {
+        half++;
+    }
+    return sign | (uint16_t)half;
+}
+
+void SimplexPost::toHalfHeights(const float *in, uint16_t *out, size_t count, bool normalize, bool invert,
+                                const SimplexCurveTable *curve)
+{
+    for (size_t i = 0; i < count; i++) {
+        out[i] = toHalf(remap(in[i], normalize, invert, curve));
+    }
+}
+
+void SimplexPost::expandGrid(const float *in, float *out, int width, int height, int stride, int rowBegin, int rowEnd)
+{
+    int lastX = (width - 1) / stride * stride;
+    int lastY = (height - 1) / stride * stride;
+    float inverse = 1.0f / stride;
+    for (int y = rowBegin; y < rowEnd; y++) {
+        int y0 = y / stride * stride;
+        int y1 = y0 + stride < lastY ? y0 + stride : lastY;
+        float fy = (y - y0) * inverse;
+        const float *top = in + (size_t)y0 * width;
+        const float *bottom = in + (size_t)y1 * width;
+        float *row = out + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            int x0 = x / stride * stride;
+            int x1 = x0 + stride < lastX ? x0 + stride : lastX;
+            float fx = (x - x0) * inverse;
+            float upper = top[x0] + (top[x1] - top[x0]) * fx;
+            float lower = bottom[x0] + (bottom[x1] - bottom[x0]) * fx;
+            row[x] = upper + (lower - upper) * fy;
+        }
+    }
+}
+
+void SimplexPost::toNormals(const float *heights, uint8_t *out, int width, int height, float strength, bool wrap,
+                            NormalLayout layout, int rowBegin, int rowEnd)
+{
+    // Clamping at the borders is a seam at the first row and column
+    toNormalsWrapped(heights, out, width, height, strength, wrap ? -1 : 0, wrap ? -1 : 0, layout, rowBegin, rowEnd);
+}
+
+void SimplexPost::toNormalsWrapped(const float *heights, uint8_t *out, int width, int height, float strength,
+                                   int seamX, int seamY, NormalLayout layout, int rowBegin, int rowEnd)
+{
+    const int stride = normalPixelSize(layout);
+    for (int y = rowBegin; y < rowEnd; y++) {
+        int up = y == seamY ? y : (y > 0 ? y - 1 : height - 1);
+        int down = y < height - 1 ? y + 1 : 0;
+        if (down == seamY) {
+            down = y;
+        }
+        const float *row = heights + (size_t)y * width;
+        const float *rowUp = heights + (size_t)up * width;
+        const float *rowDown = heights + (size_t)down * width;
+        uint8_t *pixel = out + (size_t)y * width * stride;
+
+        for (int x = 0; x < width; x++) {
+            int left = x == seamX ? x : (x > 0 ? x - 1 : width - 1);
+            int right = x < width - 1 ? x + 1 : 0;
+            if (right == seamX) {
+                right = x;
+            }
+
+            float dx = (row[right] - row[left]) * strength;
+            float dy = (rowDown[x] - rowUp[x]) * strength;
+            float inv_length = 1.0f / std::sqrt(dx * dx + dy * dy + 1.0f);
+
+            pixel[0] = toByte(-dx * inv_length * 0.5f + 0.5f);
+            pixel[1] = toByte(-dy * inv_length * 0.5f + 0.5f);
+            if (layout != NORMAL_RG8) {
+                pixel[2] = toByte(inv_length * 0.5f + 0.5f);
+                pixel[3] = layout == NORMAL_RGBA8_HEIGHT ? toByte(row[x]) : 255;
+            }
+            pixel += stride;
+        }
+    }
+}
@@ -0,0 +1,287 @@
+/**
+ * @file    SimplexGenerator.h
+ * @brief   Godot-independent noise core: fractal/warp dispatch, batch sampling and grid fill.
+ *
+ * This header is the stable native API of the plugin. It only depends on SimplexNoise and
+ * the C++ standard library, so it can be built as the `simplexcore` static library
+ * (`scons core_only=yes`) and used by other GDExtensions or command-line tools without
+ * going through Variant calls into the `Simplex` resource.
+ *
+ * A SimplexGenerator is a plain value: copying it snapshots every noise parameter, which
+ * makes it safe to hand to worker threads while the owning resource keeps being edited.
+ */
+#pragma once
+
+#include "SimplexNoise.h"
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <memory>
+#include <vector>
+
+/// Bumped whenever the public API or the generated values of this header change.
+#define SIMPLEX_CORE_API_VERSION 1
+
+/**
+ * A curve baked into evenly spaced samples over [0, 1], read back with linear interpolation.
+ * Immutable once built, so generators share it between threads through a shared_ptr.
+ */
+class SimplexCurveTable {
+public:
+    explicit SimplexCurveTable(std::vector<float> samples) : mSamples(std::move(samples)) {
+        while (mSamples.size() < 2) {
+            mSamples.push_back(mSamples.empty() ? 0.0f : mSamples.back());
+        }
+    }
+
+    // t is clamped to [0, 1]
+    float evaluate(float t) const {
+        size_t last = mSamples.size() - 1;
+        if (!(t > 0.0f)) {
+            return mSamples[0];
+        }
+        if (t >= 1.0f) {
+            return mSamples[last];
+        }
+        float position = t * last;
+        size_t index = (size_t)position;
+        return mSamples[index] + (position - index) * (mSamples[index + 1] - mSamples[index]);
+    }
+
+private:
+    std::vector<float> mSamples;
+};
+
+/// A pixel rectangle [x0, x1) x [y0, y1)
+struct SimplexRect {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+};
+
+class SimplexGenerator {
+public:
+    /// Same values as Simplex::FractalType
+    enum FractalType {
+        FRACTAL_NONE = 0,
+        FRACTAL_FBM = 1,
+        FRACTAL_RIDGED = 2,
+        FRACTAL_PING_PONG = 3,
+    };
+
+    /// Same values as Simplex::DomainWarpFractalType
+    enum DomainWarpFractalType {
+        DOMAIN_WARP_FRACTAL_NONE = 0,
+        DOMAIN_WARP_FRACTAL_PROGRESSIVE = 1,
+        DOMAIN_WARP_FRACTAL_INDEPENDENT = 2,
+    };
+
+    // Single samples, identical to Simplex::get_noise_1d/2d/3d
+    float sample(float x) const;
+    float sample(float x, float y) const;
+    float sample(float x, float y, float z) const;
+
+    /**
+     * Output shaping through mRemapCurve, identity when there is none
+     *
+     * The curve maps the noise normalized to [0, 1] onto [0, 1], and the result is scaled
+     * back to [-1, 1]. The batch and fill functions below already apply it; sample() does not.
+     */
+    float shape(float n) const {
+        return mRemapCurve ? mRemapCurve->evaluate((n + 1.0f) * 0.5f) * 2.0f - 1.0f : n;
+    }
+
+    /**
+     * True when both generators produce the same field: every noise parameter, the fractal
+     * and warp selection, and the same remap curve table. Lets callers reuse a field they
+     * generated earlier without tracking which edits touched the noise.
+     */
+    bool sameParameters(const SimplexGenerator &other) const;
+
+    // Domain warp of a 2D/3D coordinate according to mDomainWarpFractalType
+    void warp(float &x, float &y) const;
+    void warp(float &x, float &y, float &z) const;
+
+    /**
+     * Batch sampling of interleaved coordinates
+     *
+     * @param[in]  xy     count (x, y) pairs, or (x, y, z) triples for the 3D variant
+     * @param[out] out    count noise values
+     * @param[in]  count  number of points
+     */
+    void sampleBatch2D(const float *xy, float *out, size_t count) const;
+    void sampleBatch3D(const float *xyz, float *out, size_t count) const;
+
+    /**
+     * Grid fill, the raw (un-normalized) values behind Simplex::get_image
+     *
+     * Pixel (x, y) is sampled at integer coordinates, on the x/z plane when in3DSpace is set.
+     * Only the rows in [rowBegin, rowEnd) are written, so callers can split a grid between
+     * threads; out always points to the first pixel of the whole width * height grid.
+     */
+    void fillGrid2D(float *out, int width, int height, bool in3DSpace, int rowBegin, int rowEnd) const;
+    void fillSeamless2D(float *out, int width, int height, bool in3DSpace, float skirt, int rowBegin, int rowEnd) const;
+
+    /**
+     * Tile fill: the tileWidth * tileHeight block at (x0, y0) of the width * height image that
+     * fillGrid2D / fillSeamless2D would produce, written with a row stride of tileWidth.
+     */
+    void fillTile2D(float *out, int width, int height, bool seamless, bool in3DSpace, float skirt,
+                    int x0, int y0, int tileWidth, int tileHeight) const;
+
+    /**
+     * Progressive fill: only the pixels whose x and y are multiples of stride, with the values
+     * fillGrid2D / fillSeamless2D give them. With skipCoarser the pixels on the 2 * stride grid
+     * are left alone, so passes at strides 8, 4, 2 and 1 sample every pixel exactly once.
+     * Rows are counted on the stride grid: [rowBegin, rowEnd) covers y = row * stride.
+     */
+    void fillStrided2D(float *out, int width, int height, bool seamless, bool in3DSpace, float skirt,
+                       int stride, bool skipCoarser, int rowBegin, int rowEnd) const;
+
+    /**
+     * Toroidal fill for scrolling images: the pixels [x0, x1) x [y0, y1) of the unbounded image
+     * fillGrid2D samples, pixel (x, y) stored at (x mod width, y mod height) of the width * height
+     * buffer out. The rectangle should be at most width * height, or pixels overwrite each other.
+     * With a spacing, pixel (x, y) is the sample at (x * spacing, y * spacing) instead: the
+     * coarser levels of a clipmap, whose samples coincide with every spacing-th of level 0.
+     */
+    void fillWrapped2D(float *out, int width, int height, bool in3DSpace, int x0, int y0, int x1, int y1,
+                       int spacing = 1) const;
+
+    /**
+     * Pixels of the width * height window at (toX, toY) not covered by the window at
+     * (fromX, fromY): full-width rows first, then the columns beside them, so filling both
+     * rectangles with fillWrapped2D brings a wrapped buffer from one window to the other.
+     * The whole new window when the two do not overlap. Returns the rectangle count (0 to 2).
+     */
+    static int scrollExposed(int width, int height, int fromX, int fromY, int toX, int toY, SimplexRect rects[2]);
+
+    /**
+     * Region fill: pixel (x, y) is sampled at (originX + x * stepX, originY + y * stepY)
+     */
+    void fillRegion2D(float *out, int width, int height, float originX, float originY,
+                      float stepX, float stepY, int rowBegin, int rowEnd) const;
+
+    /**
+     * Volume fill, the raw values behind Simplex::get_image_3d / get_seamless_image_3d
+     *
+     * Only the slices in [sliceBegin, sliceEnd) are written; out points to the whole volume.
+     */
+    void fillGrid3D(float *out, int width, int height, int depth, int sliceBegin, int sliceEnd) const;
+    void fillSeamless3D(float *out, int width, int height, int depth, float skirt, int sliceBegin, int sliceEnd) const;
+
+    /**
+     * Streaming volume fill: same values as fillGrid3D / fillSeamless3D, but out points to
+     * slice sliceBegin, so callers only hold the slices they are producing.
+     */
+    void fillSlices3D(float *out, int width, int height, int depth, bool seamless, float skirt,
+                      int sliceBegin, int sliceEnd) const;
+
+    SimplexNoise mNoise;
+    FractalType mFractalType = FRACTAL_NONE;
+    bool mDomainWarpEnabled = false;
+    DomainWarpFractalType mDomainWarpFractalType = DOMAIN_WARP_FRACTAL_PROGRESSIVE;
+    std::shared_ptr<const SimplexCurveTable> mRemapCurve;
+
+private:
+    void shapeValues(float *values, size_t count) const;
+
+    // Image fills over the columns [x0, x1) and rows [y0, y1), pixel (x, y) written at
+    // out + (y - y0) * stride + (x - x0); sampled at (x * spacing, y * spacing)
+    void fillGrid2DRect(float *out, size_t stride, bool in3DSpace, int x0, int x1, int y0, int y1,
+                        int spacing = 1) const;
+    void fillSeamless2DRect(float *out, size_t stride, int width, int height, bool in3DSpace, float skirt,
+                            int x0, int x1, int y0, int y1) const;
+
+    // Volume fills writing slice z at out + (z - outSlice) * width * height
+    void fillGrid3DFrom(float *out, int outSlice, int width, int height, int sliceBegin, int sliceEnd) const;
+    void fillSeamless3DFrom(float *out, int outSlice, int width, int height, int depth, float skirt,
+                            int sliceBegin, int sliceEnd) const;
+};
+
+/**
+ * Post-processing shared by every image path: normalize [-1, 1] to [0, 1], invert, clamp.
+ */
+namespace SimplexPost {
+    inline float remap(float n, bool normalize, bool invert) {
+        if (normalize) {
+            n = (n + 1.0f) * 0.5f;
+        }
+        if (invert) {
+            n = 1.0f - n;
+        }
+        return n < 0.0f ? 0.0f : (n > 1.0f ? 1.0f : n);
+    }
+
+    inline uint8_t toByte(float n01) {
+        return static_cast<uint8_t>(n01 * 255.0f);
+    }
+
+    // The optional curve shapes the raw noise first, exactly like SimplexGenerator::shape
+    // (and so Simplex.remap_curve), then remap() normalizes, inverts and clamps
+    inline float remap(float n, bool normalize, bool invert, const SimplexCurveTable *curve) {
+        if (curve != nullptr) {
+            n = curve->evaluate((n + 1.0f) * 0.5f) * 2.0f - 1.0f;
+        }
+        return remap(n, normalize, invert);
+    }
+
+    // Remap and quantize count raw values into 8-bit luminance
+    void toL8(const float *in, uint8_t *out, size_t count, bool normalize, bool invert,
+              const SimplexCurveTable *curve = nullptr);
+
+    // Same quantization as toL8, then each byte indexes a 256-entry RGBA8 table (1024 bytes)
+    void toRGBA8(const float *in, uint8_t *out, size_t count, bool normalize, bool invert, const uint8_t *lut,
+                 const SimplexCurveTable *curve = nullptr);
+
+    // remap() with the optional curve, kept as floats: the [0, 1] values of FORMAT_RF images
+    // and the heights behind a normal map (in may equal out)
+    void toHeights(const float *in, float *out, size_t count, bool normalize, bool invert,
+                   const SimplexCurveTable *curve = nullptr);
+
+    // IEEE 754 binary16 bits of f, rounded to nearest even
+    uint16_t toHalf(float f);
+
+    // Same values as toHeights, stored as half floats (FORMAT_RH)
+    void toHalfHeights(const float *in, uint16_t *out, size_t count, bool normalize, bool invert,
+                       const SimplexCurveTable *curve = nullptr);
+
+    enum NormalLayout {
+        NORMAL_RGBA8,           ///< xyz, opaque alpha
+        NORMAL_RGBA8_HEIGHT,    ///< xyz, height in alpha
+        NORMAL_RG8,             ///< xy only, z = sqrt(1 - x^2 - y^2) is rebuilt by the shader
+    };
+
+    /**
+     * Full-resolution preview of a progressive fill: every pixel bilinearly interpolated from
+     * the pixels of in on the stride grid (see SimplexGenerator::fillStrided2D), edges
+     * clamped to the last grid row and column. in and out must not overlap.
+     */
+    void expandGrid(const float *in, float *out, int width, int height, int stride, int rowBegin, int rowEnd);
+
+    // Bytes per pixel written by toNormals() for a layout
+    inline int normalPixelSize(NormalLayout layout) {
+        return layout == NORMAL_RG8 ? 2 : 4;
+    }
+
+    /**
+     * Tangent-space normal map of a [0, 1] height field
+     *
+     * Central differences scaled by strength. Neighbours past the border wrap around when
+     * wrap is set (seamless textures) and are clamped to the edge otherwise. Only the rows in
+     * [rowBegin, rowEnd) are written, so the work can be split between threads.
+     */
+    void toNormals(const float *heights, uint8_t *out, int width, int height, float strength, bool wrap,
+                   NormalLayout layout, int rowBegin, int rowEnd);
+
+    /**
+     * toNormals() of a field stored wrapped, like SimplexGenerator::fillWrapped2D writes it:
+     * the view starts at column seamX and row seamY and continues around the buffer.
+     * Neighbours wrap, except across the seam where they are clamped as at the border of
+     * the unwrapped view, so the result is its non-wrapping normal map, stored wrapped the
+     * same way. A seam of -1 never clamps (fully periodic, toNormals with wrap).
+     */
+    void toNormalsWrapped(const float *heights, uint8_t *out, int width, int height, float strength,
+                          int seamX, int seamY, NormalLayout layout, int rowBegin, int rowEnd);
+}
@@ -0,0 +1,195 @@
+/**
+ * @file    SimplexJobPool.cpp
+ * @brief   Priority worker pool used for all noise generation jobs.
+ */
+
+#include "SimplexJobPool.h"
+#include "SimplexTrace.h"
+
+#include <algorithm>
+#include <memory>
+
+static thread_local bool tIsWorker = false;
+
+unsigned int SimplexJobPool::defaultWorkerCount() {
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 2 ? cores - 1 : 1;
+}
+
+SimplexJobPool::SimplexJobPool(unsigned int workers) :
+    mRunning(0),
+    mNextId(1),
+    mStopping(false) {
+    startWorkers(workers);
+}
+
+SimplexJobPool::~SimplexJobPool() {
+    stopWorkers();
+}
+
+void SimplexJobPool::setWorkerCount(unsigned int workers) {
+    if (workers == 0) {
+        workers = defaultWorkerCount();
+    }
+    if (workers == mThreads.size()) {
+        return;
+    }
+    stopWorkers();
+    startWorkers(workers);
+}
+
+void SimplexJobPool::startWorkers(unsigned int workers) {
+    if (workers == 0) {
+        workers = defaultWorkerCount();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = false;
+    }
+    for (unsigned int i = 0; i < workers; i++) {
+        mThreads.emplace_back(&SimplexJobPool::workerLoop, this);
+    }
+}
+
+void SimplexJobPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mCondition.notify_all();
+    for (std::thread &thread : mThreads) {
+        thread.join();
+    }
+    mThreads.clear();
+}
+
+uint64_t SimplexJobPool::submit(Priority priority, Job job) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        id = mNextId++;
+        mQueues[priority].push_back(Entry{ id, std::move(job) });
+    }
+    mCondition.notify_one();
+    return id;
+}
+
+bool SimplexJobPool::cancel(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (std::deque<Entry> &queue : mQueues) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->id == id) {
+                queue.erase(it);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+size_t SimplexJobPool::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t count = 0;
+    for (const std::deque<Entry> &queue : mQueues) {
+        count += queue.size();
+    }
+    return count;
+}
+
+bool SimplexJobPool::isWorkerThread() {
+    return tIsWorker;
+}
+
+void SimplexJobPool::workerLoop() {
+    tIsWorker = true;
+    SIMPLEX_TRACE_THREAD_NAME("Simplex worker");
+    for (;;) {
+        Job job;
+        uint64_t id = 0;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this] {
+                if (mStopping) {
+                    return true;
+                }
+                for (const std::deque<Entry> &queue : mQueues) {
+                    if (!queue.empty()) {
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (mStopping) {
+                return;
+            }
+            for (std::deque<Entry> &queue : mQueues) {
+                if (!queue.empty()) {
+                    id = queue.front().id;
+                    job = std::move(queue.front().job);
+                    queue.pop_front();
+                    break;
+                }
+            }
+            mRunning.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            SIMPLEX_TRACE_ZONE("SimplexJobPool::job");
+            SIMPLEX_TRACE_VALUE(id);
+            job();
+        }
+        mRunning.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void SimplexJobPool::parallelFor(int count, Priority priority, const std::function<void(int begin, int end)> &fn, int grain) {
+    if (count <= 0) {
+        return;
+    }
+    SIMPLEX_TRACE_ZONE("SimplexJobPool::parallelFor");
+    SIMPLEX_TRACE_VALUE(count);
+    grain = std::max(1, grain);
+    int chunks = (count + grain - 1) / grain;
+    int helpers = std::min<int>(chunks - 1, (int)mThreads.size());
+    if (helpers <= 0) {
+        fn(0, count);
+        return;
+    }
+
+    // Helpers may start after every chunk is done; they only touch this shared state then,
+    // never fn, so the caller can return as soon as the last chunk finished.
+    struct Shared {
+        std::atomic<int> next{ 0 };
+        std::atomic<int> done{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+    const std::function<void(int, int)> *body = &fn;
+
+    auto run = [shared, body, count, grain]() {
+        for (;;) {
+            int begin = shared->next.fetch_add(grain);
+            if (begin >= count) {
+                return;
+            }
+            int end = std::min(count, begin + grain);
+            {
+                SIMPLEX_TRACE_ZONE("SimplexJobPool::parallelFor chunk");
+                SIMPLEX_TRACE_VALUE(begin);
+                (*body)(begin, end);
+            }
+            if (shared->done.fetch_add(end - begin) + (end - begin) == count) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->finished.notify_all();
+            }
+        }
+    };
+
+    for (int i = 0; i < helpers; i++) {
+        submit(priority, run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock, [&shared, count] { return shared->done.load() == count; });
+}
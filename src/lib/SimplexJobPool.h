@@ -0,0 +1,85 @@
+/**
+ * @file    SimplexJobPool.h
+ * @brief   Priority worker pool used for all noise generation jobs.
+ *
+ * Godot-independent so that the plugin, the command-line tools and native consumers of the
+ * noise core share the same threading. Queued jobs run highest priority class first, and in
+ * submission order within a class. Jobs that already started are never interrupted.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class SimplexJobPool {
+public:
+    /// Priority classes, most urgent first
+    enum Priority {
+        PRIORITY_INTERACTIVE = 0,   ///< Editor previews and anything a caller is blocking on
+        PRIORITY_NEAR = 1,          ///< Terrain close to the camera
+        PRIORITY_BACKGROUND = 2,    ///< Bakes and far away content
+        PRIORITY_MAX
+    };
+
+    typedef std::function<void()> Job;
+
+    /**
+     * @param[in] workers  Number of worker threads, 0 picks hardware_concurrency() - 1 (at least 1)
+     */
+    explicit SimplexJobPool(unsigned int workers = 0);
+    ~SimplexJobPool();
+
+    SimplexJobPool(const SimplexJobPool &) = delete;
+    SimplexJobPool &operator=(const SimplexJobPool &) = delete;
+
+    /// Restart the workers with a new count (0 = automatic). Queued jobs are kept.
+    void setWorkerCount(unsigned int workers);
+    unsigned int getWorkerCount() const { return (unsigned int)mThreads.size(); }
+
+    /// Queue a job, returns an id usable with cancel()
+    uint64_t submit(Priority priority, Job job);
+
+    /// Remove a job that has not started yet, returns false if it already ran or is running
+    bool cancel(uint64_t id);
+
+    /**
+     * Run fn over [0, count) in chunks of grain elements, on the workers and on the calling thread.
+     *
+     * Blocks until every chunk is done. The calling thread always takes part, so this is safe
+     * to call from inside a job and never waits on workers that are busy with other classes.
+     */
+    void parallelFor(int count, Priority priority, const std::function<void(int begin, int end)> &fn, int grain = 1);
+
+    size_t getQueuedCount() const;
+    size_t getRunningCount() const { return mRunning.load(std::memory_order_relaxed); }
+
+    /// True when called from one of this pool's workers
+    static bool isWorkerThread();
+
+    static unsigned int defaultWorkerCount();
+
+private:
+    struct Entry {
+        uint64_t id;
+        Job job;
+    };
+
+    void startWorkers(unsigned int workers);
+    void stopWorkers();
+    void workerLoop();
+
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<Entry> mQueues[PRIORITY_MAX];
+    std::vector<std::thread> mThreads;
+    std::atomic<size_t> mRunning;
+    uint64_t mNextId;
+    bool mStopping;
+};
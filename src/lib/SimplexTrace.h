@@ -0,0 +1,37 @@
+/**
+ * @file    SimplexTrace.h
+ * @brief   Optional timeline profiler zones around the noise hot paths.
+ *
+ * Build with `scons tracy=yes tracy_path=<tracy checkout>` to define SIMPLEX_TRACY and link
+ * the Tracy client; every macro below then opens a named zone (or tags the current one) that
+ * shows up next to the engine's own frame in the Tracy timeline. Without it the macros expand
+ * to nothing, so they can stay in release code.
+ *
+ * Tracy allows a single SIMPLEX_TRACE_ZONE per C++ scope; nest a block for additional zones.
+ */
+#pragma once
+
+#if defined(SIMPLEX_TRACY)
+
+#include <tracy/Tracy.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+/// Scoped zone named by a string literal, ending with the enclosing block
+#define SIMPLEX_TRACE_ZONE(name) ZoneScopedN(name)
+/// Attach a number (job id, sample or pixel count) to the zone of the current scope
+#define SIMPLEX_TRACE_VALUE(value) ZoneValue((uint64_t)(value))
+/// Attach a C string to the zone of the current scope
+#define SIMPLEX_TRACE_TEXT(text) ZoneText(text, std::strlen(text))
+/// Name the calling thread in the timeline
+#define SIMPLEX_TRACE_THREAD_NAME(name) tracy::SetThreadName(name)
+
+#else
+
+#define SIMPLEX_TRACE_ZONE(name)
+#define SIMPLEX_TRACE_VALUE(value) ((void)sizeof(value))
+#define SIMPLEX_TRACE_TEXT(text) ((void)sizeof(text))
+#define SIMPLEX_TRACE_THREAD_NAME(name) ((void)0)
+
+#endif
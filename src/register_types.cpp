@@ -1,6 +1,11 @@
 #include "register_types.hpp"
 #include "Simplex.hpp"
 #include "SimplexTexture.hpp"
+#include "SimplexTexture3D.hpp"
+#include "SimplexTerrainStreamer.hpp"
+#include "SimplexClipmap.hpp"
+#include "SimplexScheduler.hpp"
+#include "SimplexMonitors.hpp"
 
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
@@ -11,27 +16,27 @@ using namespace godot;
 void initialize_simplex_module(ModuleInitializationLevel p_level) {
     // Register Simplex at CORE level
     if (p_level == MODULE_INITIALIZATION_LEVEL_CORE) {
-        printf("[SimplexNoise] Initializing CORE level...\n");
         GDREGISTER_CLASS(Simplex);
-        printf("[SimplexNoise] Registered Simplex at CORE level\n");
     }
     
     // Register SimplexTexture at SCENE level
     if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
-        printf("[SimplexNoise] Initializing SCENE level...\n");
+        GDREGISTER_ABSTRACT_CLASS(SimplexScheduler);
+        GDREGISTER_ABSTRACT_CLASS(SimplexMonitors);
         GDREGISTER_CLASS(SimplexTexture);
-        printf("[SimplexNoise] Registered SimplexTexture at SCENE level\n");
+        GDREGISTER_CLASS(SimplexTexture3D);
+        GDREGISTER_CLASS(SimplexTerrainStreamer);
+        GDREGISTER_CLASS(SimplexClipmap);
+        SimplexScheduler::create_singleton();
+        SimplexMonitors::register_monitors();
     }
 }
 
 void uninitialize_simplex_module(ModuleInitializationLevel p_level) {
     // Cleanup at appropriate levels
-    if (p_level == MODULE_INITIALIZATION_LEVEL_CORE) {
-        printf("[SimplexNoise] Uninitializing CORE level...\n");
-    }
-    
     if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
-        printf("[SimplexNoise] Uninitializing SCENE level...\n");
+        SimplexMonitors::unregister_monitors();
+        SimplexScheduler::free_singleton();
     }
 }
 
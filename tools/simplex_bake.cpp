@@ -0,0 +1,995 @@
+/**
+ * @file    simplex_bake.cpp
+ * @brief   Headless baker: Simplex / SimplexTexture resources to image files, without Godot.
+ *
+ * Build with `scons core_only=yes bake` and run `bin/simplex_bake [options] <input>...`:
+ *
+ *   --out DIR        output directory (default: next to each input)
+ *   --format F       auto (default), png, png16, r16, r32, exr or exr-half
+ *   --width N        override the texture width (default: the resource's, else 512)
+ *   --height N       override the texture height
+ *   --project DIR    directory res:// paths resolve against (default: the nearest parent
+ *                    directory of the input holding project.godot)
+ *   --threads N      worker threads besides the main thread (default: all cores)
+ *   --compare        compare against the image saved in the resource instead of writing files
+ *
+ * Inputs are Godot text resources or scenes (.tres / .tscn) and JSON files. Every
+ * SimplexTexture in a resource file is baked to `<file>.png`, or `<file>_<id>.png` for
+ * sub-resources; a file without any SimplexTexture bakes each Simplex with the SimplexTexture
+ * defaults. A JSON file holds one object, or an array of them, with the SimplexTexture
+ * properties, a "noise" object with the Simplex properties (or a path to a .tres) and an
+ * optional "name":
+ *
+ *   { "name": "erosion", "width": 1024, "noise": { "frequency": 0.015, "fractal_type": 3 } }
+ *
+ * "auto" writes the exact pixels SimplexTexture uploads: an 8-bit PNG for L8, color ramp and
+ * normal map textures (RG8 normals as gray + alpha), an EXR for FORMAT_RF / FORMAT_RH. The
+ * other formats write the [0, 1] heights like Simplex.export_heightmap(). Resources using a
+ * remap_curve are rejected, since Curve baking needs the engine. The exit code is 1 when any
+ * input failed to bake or, with --compare, did not match.
+ */
+
+#include "SimplexExport.h"
+#include "SimplexGenerator.h"
+#include "SimplexJobPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * A parsed value, shared by JSON and the Godot text resource syntax. Constructor calls such
+ * as SubResource("id") or PackedFloat32Array(0, 1) become arrays tagged with their name.
+ */
+struct Value {
+    enum Type { NIL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = NIL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;     // STRING text, or the constructor name of an ARRAY
+    std::vector<Value> items;
+    std::vector<std::pair<std::string, Value>> members;
+
+    const Value *get(const std::string &key) const {
+        for (const auto &member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    bool isCall(const char *name) const {
+        return type == ARRAY && string == name;
+    }
+};
+
+class Parser {
+public:
+    Parser(const std::string &text, const std::string &path) : mText(text), mPath(path) {}
+
+    bool atEnd() {
+        skipSpace();
+        return mPos >= mText.size();
+    }
+
+    char peek() {
+        skipSpace();
+        return mPos < mText.size() ? mText[mPos] : '\0';
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        mPos++;
+    }
+
+    // Resource keys may contain '/' and '_' (e.g. shader_parameter/noise, metadata/x)
+    std::string identifier() {
+        skipSpace();
+        size_t start = mPos;
+        while (mPos < mText.size() && (std::isalnum((unsigned char)mText[mPos]) || mText[mPos] == '_' || mText[mPos] == '/')) {
+            mPos++;
+        }
+        if (mPos == start) {
+            fail("expected a name");
+        }
+        return mText.substr(start, mPos - start);
+    }
+
+    Value value() {
+        Value result;
+        char c = peek();
+        if (c == '"') {
+            result.type = Value::STRING;
+            result.string = quoted();
+        } else if (c == '[') {
+            result.type = Value::ARRAY;
+            mPos++;
+            list(']', result.items);
+        } else if (c == '{') {
+            result.type = Value::OBJECT;
+            mPos++;
+            while (peek() != '}') {
+                std::string key = quoted();
+                expect(':');
+                result.members.emplace_back(key, value());
+                if (peek() != ',') {
+                    break;
+                }
+                mPos++;
+            }
+            expect('}');
+        } else if (c == '-' || c == '.' || std::isdigit((unsigned char)c)) {
+            const char *start = mText.c_str() + mPos;
+            char *end = nullptr;
+            result.type = Value::NUMBER;
+            result.number = std::strtod(start, &end);
+            if (end == start) {
+                fail("bad number");
+            }
+            mPos += end - start;
+        } else {
+            std::string name = identifier();
+            if (name == "true" || name == "false") {
+                result.type = Value::BOOL;
+                result.boolean = name == "true";
+            } else if (name == "null") {
+                result.type = Value::NIL;
+            } else if (name == "inf" || name == "nan") {
+                result.type = Value::NUMBER;
+                result.number = name == "inf" ? INFINITY : NAN;
+            } else if (peek() == '(') {
+                mPos++;
+                result.type = Value::ARRAY;
+                result.string = name;
+                list(')', result.items);
+            } else {
+                fail("unknown value '" + name + "'");
+            }
+        }
+        return result;
+    }
+
+    [[noreturn]] void fail(const std::string &message) {
+        size_t line = 1 + std::count(mText.begin(), mText.begin() + std::min(mPos, mText.size()), '\n');
+        throw std::runtime_error(mPath + ":" + std::to_string(line) + ": " + message);
+    }
+
+private:
+    void skipSpace() {
+        while (mPos < mText.size()) {
+            if (std::isspace((unsigned char)mText[mPos])) {
+                mPos++;
+            } else if (mText[mPos] == ';') {
+                // Comment until the end of the line (project.godot style)
+                while (mPos < mText.size() && mText[mPos] != '\n') {
+                    mPos++;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    std::string quoted() {
+        expect('"');
+        std::string out;
+        while (mPos < mText.size() && mText[mPos] != '"') {
+            char c = mText[mPos++];
+            if (c == '\\' && mPos < mText.size()) {
+                c = mText[mPos++];
+                c = c == 'n' ? '\n' : (c == 't' ? '\t' : c);
+            }
+            out += c;
+        }
+        expect('"');
+        return out;
+    }
+
+    void list(char close, std::vector<Value> &items) {
+        while (peek() != close) {
+            items.push_back(value());
+            if (peek() != ',') {
+                break;
+            }
+            mPos++;
+        }
+        expect(close);
+    }
+
+    const std::string &mText;
+    std::string mPath;
+    size_t mPos = 0;
+};
+
+struct Resource {
+    std::string type;
+    std::string id;         // empty for the main [resource]
+    std::string path;       // ext_resource only
+    std::vector<std::pair<std::string, Value>> properties;
+};
+
+/**
+ * A .tres / .tscn file: [ext_resource], [sub_resource] and [resource] sections, nodes skipped
+ */
+struct ResourceFile {
+    std::string path;
+    std::string type;       // gd_resource type, empty for scenes
+    std::map<std::string, Resource> external;
+    std::map<std::string, Resource> internal;
+    std::vector<std::string> order;     // sub-resource ids in file order
+    Resource main;
+};
+
+std::string readFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+ResourceFile parseResourceFile(const std::string &path) {
+    std::string text = readFile(path);
+    Parser parser(text, path);
+    ResourceFile file;
+    file.path = path;
+    Resource *current = nullptr;
+    Resource ignored;
+    while (!parser.atEnd()) {
+        if (parser.peek() == '[') {
+            parser.expect('[');
+            std::string section = parser.identifier();
+            Resource header;
+            while (parser.peek() != ']') {
+                std::string key = parser.identifier();
+                parser.expect('=');
+                Value value = parser.value();
+                if (key == "type" && value.type == Value::STRING) {
+                    header.type = value.string;
+                } else if (key == "id") {
+                    header.id = value.type == Value::NUMBER ? std::to_string((long long)value.number) : value.string;
+                } else if (key == "path") {
+                    header.path = value.string;
+                }
+            }
+            parser.expect(']');
+
+            if (section == "gd_resource") {
+                file.type = header.type;
+                current = &ignored;
+            } else if (section == "ext_resource") {
+                file.external[header.id] = header;
+                current = &ignored;
+            } else if (section == "sub_resource") {
+                file.order.push_back(header.id);
+                current = &(file.internal[header.id] = header);
+            } else if (section == "resource") {
+                file.main.type = file.type;
+                current = &file.main;
+            } else {
+                current = &ignored;
+            }
+        } else {
+            std::string key = parser.identifier();
+            parser.expect('=');
+            Value value = parser.value();
+            if (current == nullptr) {
+                parser.fail("property outside of a section");
+            }
+            if (current != &ignored) {
+                current->properties.emplace_back(key, std::move(value));
+            }
+        }
+    }
+    return file;
+}
+
+// Parameters of one output image, the SimplexTexture properties and defaults
+struct TextureSettings {
+    int width = 512;
+    int height = 512;
+    bool invert = false;
+    bool in3DSpace = false;
+    int offsetX = 0;        // scroll position, stored wrapped like SimplexTexture::set_offset()
+    int offsetY = 0;
+    bool normalize = true;
+    int outputFormat = 0;   // Image::FORMAT_L8 (0), FORMAT_RF (8) or FORMAT_RH (12)
+    bool seamless = false;
+    float seamlessBlendSkirt = 0.1f;
+    bool asNormalMap = false;
+    float bumpStrength = 8.0f;
+    int normalMapPacking = SimplexPost::NORMAL_RGBA8;
+    std::vector<uint8_t> colorRampLut;  // empty when there is no color ramp
+};
+
+const int IMAGE_FORMAT_L8 = 0;
+const int IMAGE_FORMAT_RF = 8;
+const int IMAGE_FORMAT_RH = 12;
+
+struct BakeJob {
+    std::string source;
+    std::string name;
+    SimplexGenerator generator;
+    TextureSettings texture;
+    // Pixels of the image saved with the resource, for --compare
+    std::vector<uint8_t> saved;
+    std::string savedFormat;
+    int savedWidth = 0;
+    int savedHeight = 0;
+};
+
+struct Options {
+    std::string out;
+    std::string format = "auto";
+    int width = 0;
+    int height = 0;
+    std::string project;
+    int threads = -1;
+    bool compare = false;
+};
+
+double toNumber(const Value &value, const std::string &key) {
+    if (value.type == Value::NUMBER) {
+        return value.number;
+    }
+    if (value.type == Value::BOOL) {
+        return value.boolean ? 1.0 : 0.0;
+    }
+    throw std::runtime_error("property " + key + " is not a number");
+}
+
+float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/**
+ * Same effect as setting the property on a Simplex resource (see Simplex::_set and the
+ * setters), including their clamping. Returns false for unknown properties.
+ */
+bool applyNoiseProperty(SimplexGenerator &generator, const std::string &key, const Value &value) {
+    SimplexNoise &noise = generator.mNoise;
+    if (key == "remap_curve") {
+        if (value.type != Value::NIL) {
+            throw std::runtime_error("remap_curve is not supported by the baker");
+        }
+        return true;
+    }
+    if (key == "script" || key == "resource_name" || key == "resource_local_to_scene" || key.compare(0, 9, "metadata/") == 0) {
+        return true;
+    }
+    double n = toNumber(value, key);
+    if (key == "seed") {
+        noise.mSeed = (int32_t)(int64_t)n;
+    } else if (key == "frequency") {
+        noise.mFrequency = clampf((float)n, 0.0f, 1.0f);
+    } else if (key == "fractal_type") {
+        generator.mFractalType = (SimplexGenerator::FractalType)(int64_t)n;
+    } else if (key == "fractal_octaves") {
+        noise.mOctaves = (uint16_t)(int64_t)n;
+    } else if (key == "fractal_lacunarity") {
+        noise.mLacunarity = (float)n;
+    } else if (key == "fractal_gain") {
+        noise.mPersistence = (float)n;
+    } else if (key == "fractal_ping_pong_strength") {
+        noise.mPingPongStrength = (float)n;
+    } else if (key == "domain_warp_enabled") {
+        generator.mDomainWarpEnabled = n != 0.0;
+    } else if (key == "domain_warp_type") {
+        // Only simplex warping exists
+    } else if (key == "domain_warp_amplitude") {
+        noise.mDomainWarpAmplitude = (float)n;
+    } else if (key == "domain_warp_frequency") {
+        noise.mDomainWarpFrequency = clampf((float)n, 0.0f, 1.0f);
+    } else if (key == "domain_warp_fractal_type") {
+        generator.mDomainWarpFractalType = (SimplexGenerator::DomainWarpFractalType)(int64_t)n;
+    } else if (key == "domain_warp_octaves") {
+        noise.mDomainWarpFractalOctaves = (uint16_t)(int64_t)n;
+    } else if (key == "domain_warp_lacunarity") {
+        noise.mDomainWarpFractalLacunarity = (float)n;
+    } else if (key == "domain_warp_gain") {
+        noise.mDomainWarpFractalGain = (float)n;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct GradientPoint {
+    float offset;
+    float color[4];
+};
+
+/**
+ * 256-entry RGBA8 table of a Gradient, as SimplexTexture::bake_color_ramp() builds it with
+ * Gradient::sample(). Linear and constant interpolation in sRGB space are supported.
+ */
+std::vector<uint8_t> bakeColorRamp(std::vector<float> offsets, std::vector<float> colors, int interpolation, int colorSpace) {
+    if (interpolation > 1 || colorSpace != 0) {
+        throw std::runtime_error("only linear or constant color ramps in sRGB space are supported by the baker");
+    }
+    std::vector<GradientPoint> points(std::min(offsets.size(), colors.size() / 4));
+    for (size_t i = 0; i < points.size(); i++) {
+        points[i].offset = offsets[i];
+        std::copy(colors.begin() + i * 4, colors.begin() + i * 4 + 4, points[i].color);
+    }
+    std::vector<uint8_t> lut;
+    if (points.empty()) {
+        return lut;
+    }
+    std::stable_sort(points.begin(), points.end(), [](const GradientPoint &a, const GradientPoint &b) {
+        return a.offset < b.offset;
+    });
+
+    lut.resize(256 * 4);
+    for (int i = 0; i < 256; i++) {
+        float offset = i / 255.0f;
+        // Binary search, as in Gradient::get_color_at_offset()
+        int low = 0;
+        int high = (int)points.size() - 1;
+        int middle = 0;
+        const float *color = nullptr;
+        while (low <= high) {
+            middle = (low + high) / 2;
+            if (points[middle].offset > offset) {
+                high = middle - 1;
+            } else if (points[middle].offset < offset) {
+                low = middle + 1;
+            } else {
+                color = points[middle].color;
+                break;
+            }
+        }
+        float mixed[4];
+        if (color == nullptr) {
+            if (points[middle].offset > offset) {
+                middle--;
+            }
+            int first = middle;
+            int second = middle + 1;
+            if (second >= (int)points.size()) {
+                color = points.back().color;
+            } else if (first < 0) {
+                color = points.front().color;
+            } else if (interpolation == 1) {
+                color = points[first].color;
+            } else {
+                float weight = (offset - points[first].offset) / (points[second].offset - points[first].offset);
+                for (int c = 0; c < 4; c++) {
+                    mixed[c] = points[first].color[c] + (points[second].color[c] - points[first].color[c]) * weight;
+                }
+                color = mixed;
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            lut[i * 4 + c] = (uint8_t)std::min(std::max(color[c] * 255.0, 0.0), 255.0);
+        }
+    }
+    return lut;
+}
+
+std::vector<float> floats(const Value &value) {
+    std::vector<float> out;
+    for (const Value &item : value.items) {
+        if (item.type == Value::ARRAY) {
+            for (const Value &channel : item.items) {
+                out.push_back((float)channel.number);
+            }
+        } else {
+            out.push_back((float)item.number);
+        }
+    }
+    return out;
+}
+
+// Gradient properties, from a Gradient resource or a JSON object with the same keys
+std::vector<uint8_t> bakeGradientProperties(const std::vector<std::pair<std::string, Value>> &properties) {
+    std::vector<float> offsets = { 0.0f, 1.0f };
+    std::vector<float> colors = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    int interpolation = 0;
+    int colorSpace = 0;
+    for (const auto &property : properties) {
+        if (property.first == "offsets") {
+            offsets = floats(property.second);
+        } else if (property.first == "colors") {
+            colors = floats(property.second);
+        } else if (property.first == "interpolation_mode") {
+            interpolation = (int)property.second.number;
+        } else if (property.first == "interpolation_color_space") {
+            colorSpace = (int)property.second.number;
+        }
+    }
+    return bakeColorRamp(offsets, colors, interpolation, colorSpace);
+}
+
+/**
+ * Resolves SubResource / ExtResource references and loads external files, cached by path
+ */
+class Loader {
+public:
+    explicit Loader(std::string project) : mProject(std::move(project)) {}
+
+    std::string resolve(const std::string &path, const std::string &from) {
+        if (path.compare(0, 6, "res://") == 0) {
+            std::string root = mProject.empty() ? findProject(from) : mProject;
+            return root + "/" + path.substr(6);
+        }
+        if (!path.empty() && path[0] == '/') {
+            return path;
+        }
+        size_t slash = from.find_last_of('/');
+        return slash == std::string::npos ? path : from.substr(0, slash + 1) + path;
+    }
+
+    const ResourceFile &load(const std::string &path) {
+        auto found = mFiles.find(path);
+        if (found == mFiles.end()) {
+            found = mFiles.emplace(path, parseResourceFile(path)).first;
+        }
+        return found->second;
+    }
+
+    // The resource a SubResource("id") / ExtResource("id") value points to
+    const Resource &follow(const ResourceFile &file, const Value &reference, const ResourceFile **r_owner) {
+        if (reference.items.empty()) {
+            throw std::runtime_error(file.path + ": empty resource reference");
+        }
+        const Value &idValue = reference.items[0];
+        std::string id = idValue.type == Value::NUMBER ? std::to_string((long long)idValue.number) : idValue.string;
+        if (reference.isCall("SubResource")) {
+            auto found = file.internal.find(id);
+            if (found == file.internal.end()) {
+                throw std::runtime_error(file.path + ": missing sub_resource " + id);
+            }
+            *r_owner = &file;
+            return found->second;
+        }
+        auto found = file.external.find(id);
+        if (found == file.external.end()) {
+            throw std::runtime_error(file.path + ": missing ext_resource " + id);
+        }
+        const ResourceFile &external = load(resolve(found->second.path, file.path));
+        *r_owner = &external;
+        return external.main;
+    }
+
+private:
+    static std::string findProject(const std::string &from) {
+        std::string directory = from;
+        while (true) {
+            size_t slash = directory.find_last_of('/');
+            directory = slash == std::string::npos ? "." : directory.substr(0, slash);
+            if (std::ifstream(directory + "/project.godot")) {
+                return directory;
+            }
+            if (slash == std::string::npos || directory.empty() || directory == ".") {
+                throw std::runtime_error("no project.godot above " + from + ", pass --project");
+            }
+        }
+    }
+
+    std::string mProject;
+    std::map<std::string, ResourceFile> mFiles;
+};
+
+void applyNoise(SimplexGenerator &generator, const Resource &noise, const std::string &where) {
+    for (const auto &property : noise.properties) {
+        if (!applyNoiseProperty(generator, property.first, property.second)) {
+            std::fprintf(stderr, "%s: ignoring unknown Simplex property %s\n", where.c_str(), property.first.c_str());
+        }
+    }
+}
+
+/**
+ * SimplexTexture properties onto a job; references (noise, color_ramp, image) go through
+ * the loader when they come from a resource file.
+ */
+void applyTexture(BakeJob &job, const std::vector<std::pair<std::string, Value>> &properties, Loader &loader,
+                  const ResourceFile *file) {
+    TextureSettings &texture = job.texture;
+    for (const auto &property : properties) {
+        const std::string &key = property.first;
+        const Value &value = property.second;
+        if (key == "noise") {
+            if (value.type == Value::OBJECT) {
+                Resource noise;
+                noise.properties = value.members;
+                applyNoise(job.generator, noise, job.source);
+            } else if (value.type == Value::STRING) {
+                const ResourceFile &external = loader.load(loader.resolve(value.string, job.source));
+                applyNoise(job.generator, external.main, external.path);
+            } else if (file != nullptr && value.type == Value::ARRAY) {
+                const ResourceFile *owner = nullptr;
+                const Resource &noise = loader.follow(*file, value, &owner);
+                applyNoise(job.generator, noise, owner->path);
+            }
+        } else if (key == "color_ramp") {
+            if (value.type == Value::OBJECT) {
+                texture.colorRampLut = bakeGradientProperties(value.members);
+            } else if (file != nullptr && value.type == Value::ARRAY) {
+                const ResourceFile *owner = nullptr;
+                texture.colorRampLut = bakeGradientProperties(loader.follow(*file, value, &owner).properties);
+            }
+        } else if (key == "remap_curve") {
+            if (value.type != Value::NIL) {
+                throw std::runtime_error("remap_curve is not supported by the baker");
+            }
+        } else if (key == "image") {
+            if (file != nullptr && value.type == Value::ARRAY) {
+                const ResourceFile *owner = nullptr;
+                const Resource &image = loader.follow(*file, value, &owner);
+                for (const auto &data : image.properties) {
+                    if (data.first != "data" || data.second.type != Value::OBJECT) {
+                        continue;
+                    }
+                    const Value *bytes = data.second.get("data");
+                    const Value *format = data.second.get("format");
+                    const Value *width = data.second.get("width");
+                    const Value *height = data.second.get("height");
+                    if (bytes && format && width && height) {
+                        job.savedFormat = format->string;
+                        job.savedWidth = (int)width->number;
+                        job.savedHeight = (int)height->number;
+                        job.saved.reserve(bytes->items.size());
+                        for (const Value &byte : bytes->items) {
+                            job.saved.push_back((uint8_t)byte.number);
+                        }
+                    }
+                }
+            }
+        } else if (key == "width") {
+            texture.width = std::max(1, (int)toNumber(value, key));
+        } else if (key == "height") {
+            texture.height = std::max(1, (int)toNumber(value, key));
+        } else if (key == "invert") {
+            texture.invert = toNumber(value, key) != 0.0;
+        } else if (key == "in_3d_space") {
+            texture.in3DSpace = toNumber(value, key) != 0.0;
+        } else if (key == "normalize") {
+            texture.normalize = toNumber(value, key) != 0.0;
+        } else if (key == "output_format") {
+            texture.outputFormat = (int)toNumber(value, key);
+            if (texture.outputFormat != IMAGE_FORMAT_L8 && texture.outputFormat != IMAGE_FORMAT_RF &&
+                texture.outputFormat != IMAGE_FORMAT_RH) {
+                throw std::runtime_error("unsupported output_format " + std::to_string(texture.outputFormat));
+            }
+        } else if (key == "seamless") {
+            texture.seamless = toNumber(value, key) != 0.0;
+        } else if (key == "seamless_blend_skirt") {
+            texture.seamlessBlendSkirt = clampf((float)toNumber(value, key), 0.0f, 0.5f);
+        } else if (key == "as_normal_map") {
+            texture.asNormalMap = toNumber(value, key) != 0.0;
+        } else if (key == "bump_strength") {
+            texture.bumpStrength = (float)toNumber(value, key);
+        } else if (key == "normal_map_packing") {
+            texture.normalMapPacking = (int)toNumber(value, key);
+        } else if (key == "offset") {
+            // Vector2i(x, y) in resources, [x, y] in JSON
+            if (value.type != Value::ARRAY || value.items.size() != 2) {
+                throw std::runtime_error("property offset is not a Vector2i");
+            }
+            texture.offsetX = (int)toNumber(value.items[0], key);
+            texture.offsetY = (int)toNumber(value.items[1], key);
+        } else if (key == "generate_mipmaps" || key == "compress_mode" || key == "cache_field" ||
+                   key == "generate_async" || key == "progressive" || key == "time_slice_usec" ||
+                   key == "generation_priority" || key == "script" || key == "resource_name" ||
+                   key == "resource_local_to_scene" || key.compare(0, 9, "metadata/") == 0) {
+            // Upload and scheduling settings do not change the pixels
+        } else {
+            std::fprintf(stderr, "%s: ignoring unknown SimplexTexture property %s\n", job.source.c_str(), key.c_str());
+        }
+    }
+}
+
+std::string stem(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+void collectResourceJobs(const std::string &path, Loader &loader, std::vector<BakeJob> &jobs) {
+    const ResourceFile &file = loader.load(path);
+    size_t first = jobs.size();
+    auto add = [&](const Resource &resource, bool texture) {
+        BakeJob job;
+        job.source = path;
+        job.name = resource.id.empty() ? stem(path) : stem(path) + "_" + resource.id;
+        if (texture) {
+            applyTexture(job, resource.properties, loader, &file);
+        } else {
+            applyNoise(job.generator, resource, path);
+        }
+        jobs.push_back(std::move(job));
+    };
+
+    for (const std::string &id : file.order) {
+        if (file.internal.at(id).type == "SimplexTexture") {
+            add(file.internal.at(id), true);
+        }
+    }
+    if (file.main.type == "SimplexTexture") {
+        add(file.main, true);
+    }
+    if (jobs.size() > first) {
+        return;
+    }
+    for (const std::string &id : file.order) {
+        if (file.internal.at(id).type == "Simplex") {
+            add(file.internal.at(id), false);
+        }
+    }
+    if (file.main.type == "Simplex") {
+        add(file.main, false);
+    }
+    if (jobs.size() == first) {
+        throw std::runtime_error(path + ": no Simplex or SimplexTexture resource");
+    }
+}
+
+void collectJsonJobs(const std::string &path, Loader &loader, std::vector<BakeJob> &jobs) {
+    std::string text = readFile(path);
+    Parser parser(text, path);
+    Value root = parser.value();
+    std::vector<const Value *> entries;
+    if (root.type == Value::ARRAY) {
+        for (const Value &item : root.items) {
+            entries.push_back(&item);
+        }
+    } else {
+        entries.push_back(&root);
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i]->type != Value::OBJECT) {
+            throw std::runtime_error(path + ": expected an object per texture");
+        }
+        BakeJob job;
+        job.source = path;
+        const Value *name = entries[i]->get("name");
+        job.name = name ? name->string : (entries.size() == 1 ? stem(path) : stem(path) + "_" + std::to_string(i));
+        std::vector<std::pair<std::string, Value>> properties;
+        for (const auto &member : entries[i]->members) {
+            if (member.first != "name") {
+                properties.push_back(member);
+            }
+        }
+        applyTexture(job, properties, loader, nullptr);
+        jobs.push_back(std::move(job));
+    }
+}
+
+/**
+ * The 8-bit pixels SimplexTexture::_generate_image() produces (L8, RGBA8 or RG8), split across
+ * the pool like Simplex::fill_field_2d(). Empty for float textures; values keeps the field.
+ */
+std::vector<uint8_t> generateImage(const BakeJob &job, SimplexJobPool &pool, std::vector<float> &values) {
+    const TextureSettings &t = job.texture;
+    const SimplexGenerator &generator = job.generator;
+    size_t count = (size_t)t.width * t.height;
+    values.resize(count);
+    // Seamless textures ignore the offset, as in SimplexTexture
+    bool scrolled = !t.seamless && (t.offsetX != 0 || t.offsetY != 0);
+    pool.parallelFor(t.height, SimplexJobPool::PRIORITY_INTERACTIVE, [&](int begin, int end) {
+        if (t.seamless) {
+            generator.fillSeamless2D(values.data(), t.width, t.height, t.in3DSpace, t.seamlessBlendSkirt, begin, end);
+        } else if (scrolled) {
+            generator.fillWrapped2D(values.data(), t.width, t.height, t.in3DSpace, t.offsetX, t.offsetY + begin,
+                t.offsetX + t.width, t.offsetY + end);
+        } else {
+            generator.fillGrid2D(values.data(), t.width, t.height, t.in3DSpace, begin, end);
+        }
+    }, std::max(1, 4096 / t.width));
+
+    std::vector<uint8_t> pixels;
+    if (t.asNormalMap) {
+        SimplexPost::toHeights(values.data(), values.data(), count, t.normalize, t.invert);
+        SimplexPost::NormalLayout layout = (SimplexPost::NormalLayout)t.normalMapPacking;
+        pixels.resize(count * SimplexPost::normalPixelSize(layout));
+        // Periodic when seamless, else clamped where the (possibly wrapped) view starts
+        int seamX = t.seamless ? -1 : ((t.offsetX % t.width) + t.width) % t.width;
+        int seamY = t.seamless ? -1 : ((t.offsetY % t.height) + t.height) % t.height;
+        pool.parallelFor(t.height, SimplexJobPool::PRIORITY_INTERACTIVE, [&](int begin, int end) {
+            SimplexPost::toNormalsWrapped(values.data(), pixels.data(), t.width, t.height, t.bumpStrength,
+                seamX, seamY, layout, begin, end);
+        }, std::max(1, 16384 / t.width));
+    } else if (!t.colorRampLut.empty()) {
+        pixels.resize(count * 4);
+        SimplexPost::toRGBA8(values.data(), pixels.data(), count, t.normalize, t.invert, t.colorRampLut.data());
+    } else if (t.outputFormat == IMAGE_FORMAT_L8) {
+        pixels.resize(count);
+        SimplexPost::toL8(values.data(), pixels.data(), count, t.normalize, t.invert);
+    }
+    // FORMAT_RF / FORMAT_RH: the heights stay in values, the writer encodes them
+    return pixels;
+}
+
+int writeFile(const std::string &path, const std::function<bool(const SimplexExport::Sink &)> &body) {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "%s: cannot open for writing\n", path.c_str());
+        return 1;
+    }
+    bool ok = body([file](const uint8_t *data, size_t size) {
+        return std::fwrite(data, 1, size, file) == size;
+    });
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::fprintf(stderr, "%s: write failed\n", path.c_str());
+    }
+    return ok ? 0 : 1;
+}
+
+std::string outputPath(const BakeJob &job, const Options &options, const char *extension) {
+    std::string directory = options.out;
+    if (directory.empty()) {
+        size_t slash = job.source.find_last_of('/');
+        directory = slash == std::string::npos ? "." : job.source.substr(0, slash);
+    }
+    return directory + "/" + job.name + "." + extension;
+}
+
+int writeJob(const BakeJob &job, const Options &options, const std::vector<uint8_t> &pixels, std::vector<float> &values) {
+    const TextureSettings &t = job.texture;
+    std::string format = options.format;
+    bool image8 = !pixels.empty();
+
+    if (format == "auto" || format == "png") {
+        if (image8) {
+            SimplexExport::PngWriter::ColorType color = SimplexExport::PngWriter::COLOR_GRAY;
+            size_t channels = pixels.size() / ((size_t)t.width * t.height);
+            if (channels == 2) {
+                color = SimplexExport::PngWriter::COLOR_GRAY_ALPHA;
+            } else if (channels == 4) {
+                color = SimplexExport::PngWriter::COLOR_RGBA;
+            }
+            std::string path = outputPath(job, options, "png");
+            std::printf("  %s\n", path.c_str());
+            return writeFile(path, [&](const SimplexExport::Sink &sink) {
+                SimplexExport::PngWriter writer(t.width, t.height, 8, color, sink);
+                return writer.writeRows(pixels.data(), t.height) && writer.finish();
+            });
+        }
+        if (format == "png") {
+            std::fprintf(stderr, "%s: %s is a float texture, use --format auto, exr or r32\n",
+                job.source.c_str(), job.name.c_str());
+            return 1;
+        }
+        format = t.outputFormat == IMAGE_FORMAT_RH ? "exr-half" : "exr";
+    }
+
+    SimplexExport::Format heightFormat;
+    if (format == "png16") {
+        heightFormat = SimplexExport::FORMAT_PNG16;
+    } else if (format == "r16") {
+        heightFormat = SimplexExport::FORMAT_RAW_R16;
+    } else if (format == "r32") {
+        heightFormat = SimplexExport::FORMAT_RAW_R32;
+    } else if (format == "exr") {
+        heightFormat = SimplexExport::FORMAT_EXR;
+    } else {
+        heightFormat = SimplexExport::FORMAT_EXR_HALF;
+    }
+    // Heights formats ignore the color ramp and normal map settings, like export_heightmap().
+    // A normal map already turned the field into heights.
+    if (!t.asNormalMap) {
+        SimplexPost::toHeights(values.data(), values.data(), values.size(), t.normalize, t.invert);
+    }
+    std::string path = outputPath(job, options, SimplexExport::extension(heightFormat));
+    std::printf("  %s\n", path.c_str());
+    return writeFile(path, [&](const SimplexExport::Sink &sink) {
+        SimplexExport::HeightWriter writer(heightFormat, t.width, t.height, sink);
+        return writer.writeRows(values.data(), t.height) && writer.finish();
+    });
+}
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            options.out = argv[++i];
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            options.format = argv[++i];
+        } else if (std::strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            options.width = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            options.height = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--project") == 0 && i + 1 < argc) {
+            options.project = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--compare") == 0) {
+            options.compare = true;
+        } else if (argv[i][0] != '-') {
+            inputs.push_back(argv[i]);
+        } else {
+            inputs.clear();
+            break;
+        }
+    }
+    static const char *formats[] = { "auto", "png", "png16", "r16", "r32", "exr", "exr-half" };
+    if (inputs.empty() || std::find_if(std::begin(formats), std::end(formats), [&](const char *f) {
+            return options.format == f; }) == std::end(formats)) {
+        std::fprintf(stderr, "usage: %s [--out DIR] [--format auto|png|png16|r16|r32|exr|exr-half] [--width N] "
+                             "[--height N] [--project DIR] [--threads N] [--compare] <file.tres|file.tscn|file.json>...\n", argv[0]);
+        return 2;
+    }
+
+    Loader loader(options.project);
+    std::vector<BakeJob> jobs;
+    int failures = 0;
+    for (const std::string &input : inputs) {
+        try {
+            std::string extension = input.substr(input.find_last_of('.') + 1);
+            if (extension == "json") {
+                collectJsonJobs(input, loader, jobs);
+            } else {
+                collectResourceJobs(input, loader, jobs);
+            }
+        } catch (const std::exception &error) {
+            std::fprintf(stderr, "%s\n", error.what());
+            failures++;
+        }
+    }
+
+    // parallelFor also runs chunks on the calling thread
+    SimplexJobPool pool(options.threads < 0 ? 0 : (unsigned int)std::max(1, options.threads));
+    for (BakeJob &job : jobs) {
+        if (options.width > 0) {
+            job.texture.width = options.width;
+        }
+        if (options.height > 0) {
+            job.texture.height = options.height;
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> values;
+        std::vector<uint8_t> pixels = generateImage(job, pool, values);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s: %s %dx%d in %.1f ms\n", job.source.c_str(), job.name.c_str(), job.texture.width,
+            job.texture.height, ms);
+
+        if (!options.compare) {
+            failures += writeJob(job, options, pixels, values);
+            continue;
+        }
+        // Saved images keep their mipmaps after the base level
+        size_t base = pixels.size();
+        if (job.saved.empty()) {
+            std::printf("  no saved image to compare against\n");
+        } else if (job.savedWidth != job.texture.width || job.savedHeight != job.texture.height ||
+                   job.saved.size() < base || base == 0) {
+            std::printf("  MISMATCH: saved image is %s %dx%d\n", job.savedFormat.c_str(), job.savedWidth, job.savedHeight);
+            failures++;
+        } else {
+            size_t differing = 0;
+            for (size_t i = 0; i < base; i++) {
+                differing += pixels[i] != job.saved[i];
+            }
+            std::printf("  %s: %zu of %zu bytes differ\n", differing == 0 ? "identical" : "MISMATCH", differing, base);
+            failures += differing != 0;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file    simplex_bench.cpp
+ * @brief   Micro and macro benchmarks of the Godot-independent noise core.
+ *
+ * Build with `scons core_only=yes bench` and run `bin/simplex_bench [options]`:
+ *
+ *   --quick          smaller sizes and shorter runs, for smoke testing
+ *   --filter TEXT    only run benchmarks whose name contains TEXT
+ *   --out FILE       write the JSON report to FILE instead of stdout
+ *
+ * Each entry of the JSON report is the best of several timed runs, as ns per sample and
+ * ms per run; the "image" group mirrors get_image()/get_image_3d() without the Godot upload.
+ */
+
+#include "SimplexGenerator.h"
+#include "SimplexJobPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    bool quick = false;
+    std::string filter;
+    std::string out;
+};
+
+struct Result {
+    std::string name;
+    std::string group;
+    double nsPerSample;
+    double msPerRun;
+    long long samples;
+    int threads;
+};
+
+volatile float gSink = 0.0f;
+
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Time run() (which performs samplesPerRun samples) and keep the best of several repeats
+ */
+Result measure(const Options &options, const std::string &group, const std::string &name, int threads,
+               long long samplesPerRun, const std::function<void()> &run) {
+    const double minSeconds = options.quick ? 0.02 : 0.2;
+    const int repeats = options.quick ? 2 : 5;
+
+    run(); // warm up caches and the worker pool
+    double best = 1e30;
+    for (int r = 0; r < repeats; r++) {
+        int iterations = 0;
+        double start = nowSeconds();
+        double elapsed = 0.0;
+        do {
+            run();
+            iterations++;
+            elapsed = nowSeconds() - start;
+        } while (elapsed < minSeconds);
+        best = std::min(best, elapsed / iterations);
+    }
+    return Result{ name, group, best * 1e9 / samplesPerRun, best * 1e3, samplesPerRun, threads };
+}
+
+bool selected(const Options &options, const std::string &name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+const char *fractalName(SimplexGenerator::FractalType type) {
+    switch (type) {
+    case SimplexGenerator::FRACTAL_FBM: return "fbm";
+    case SimplexGenerator::FRACTAL_RIDGED: return "ridged";
+    case SimplexGenerator::FRACTAL_PING_PONG: return "pingpong";
+    default: return "none";
+    }
+}
+
+const char *warpName(int warp) {
+    switch (warp) {
+    case 1: return "single";
+    case 2: return "progressive";
+    case 3: return "independent";
+    default: return "off";
+    }
+}
+
+// warp 0 = disabled, otherwise 1 + DomainWarpFractalType
+SimplexGenerator makeGenerator(SimplexGenerator::FractalType type, size_t octaves, int warp) {
+    SimplexGenerator generator;
+    generator.mNoise.mSeed = 1337;
+    generator.mNoise.mOctaves = octaves;
+    generator.mFractalType = type;
+    generator.mDomainWarpEnabled = warp != 0;
+    if (warp != 0) {
+        generator.mDomainWarpFractalType = (SimplexGenerator::DomainWarpFractalType)(warp - 1);
+    }
+    return generator;
+}
+
+void runKernels(const Options &options, std::vector<Result> &results) {
+    const int count = options.quick ? 1 << 14 : 1 << 18;
+
+    if (selected(options, "kernel/1d")) {
+        results.push_back(measure(options, "kernel", "kernel/1d", 1, count, [count]() {
+            float sum = 0.0f;
+            for (int i = 0; i < count; i++) {
+                sum += SimplexNoise::noise(i * 0.173f, 0);
+            }
+            gSink = sum;
+        }));
+    }
+    if (selected(options, "kernel/2d")) {
+        results.push_back(measure(options, "kernel", "kernel/2d", 1, count, [count]() {
+            float sum = 0.0f;
+            for (int i = 0; i < count; i++) {
+                sum += SimplexNoise::noise((i & 511) * 0.173f, (i >> 9) * 0.173f, 0);
+            }
+            gSink = sum;
+        }));
+    }
+    if (selected(options, "kernel/3d")) {
+        results.push_back(measure(options, "kernel", "kernel/3d", 1, count, [count]() {
+            float sum = 0.0f;
+            for (int i = 0; i < count; i++) {
+                sum += SimplexNoise::noise((i & 63) * 0.173f, ((i >> 6) & 63) * 0.173f, (i >> 12) * 0.173f, 0);
+            }
+            gSink = sum;
+        }));
+    }
+}
+
+void runFractals(const Options &options, std::vector<Result> &results) {
+    const int count = options.quick ? 1 << 12 : 1 << 16;
+    const SimplexGenerator::FractalType types[] = {
+        SimplexGenerator::FRACTAL_NONE, SimplexGenerator::FRACTAL_FBM,
+        SimplexGenerator::FRACTAL_RIDGED, SimplexGenerator::FRACTAL_PING_PONG,
+    };
+    const size_t octaveCounts[] = { 1, 3, 5, 8 };
+
+    for (SimplexGenerator::FractalType type : types) {
+        for (size_t octaves : octaveCounts) {
+            // FRACTAL_NONE samples a single octave in 2D whatever mOctaves says
+            if (type == SimplexGenerator::FRACTAL_NONE && octaves != 1) {
+                continue;
+            }
+            for (int warp = 0; warp <= 3; warp++) {
+                SimplexGenerator generator = makeGenerator(type, octaves, warp);
+                std::string name = std::string("fractal/2d/") + fractalName(type) + "/o" + std::to_string(octaves) +
+                                   "/warp-" + warpName(warp);
+                if (selected(options, name)) {
+                    results.push_back(measure(options, "fractal", name, 1, count, [&generator, count]() {
+                        float sum = 0.0f;
+                        for (int i = 0; i < count; i++) {
+                            sum += generator.sample((float)(i & 255), (float)(i >> 8));
+                        }
+                        gSink = sum;
+                    }));
+                }
+            }
+
+            // 3D is measured without the warp; its cost is covered by the 2D cases
+            SimplexGenerator generator = makeGenerator(type, octaves, 0);
+            std::string name = std::string("fractal/3d/") + fractalName(type) + "/o" + std::to_string(octaves);
+            if (selected(options, name)) {
+                results.push_back(measure(options, "fractal", name, 1, count, [&generator, count]() {
+                    float sum = 0.0f;
+                    for (int i = 0; i < count; i++) {
+                        sum += generator.sample((float)(i & 31), (float)((i >> 5) & 31), (float)(i >> 10));
+                    }
+                    gSink = sum;
+                }));
+            }
+        }
+    }
+}
+
+void runImages(const Options &options, std::vector<Result> &results) {
+    std::vector<int> sizes = options.quick ? std::vector<int>{ 128, 256 } : std::vector<int>{ 256, 512, 1024, 2048 };
+    std::vector<int> volumeSizes = options.quick ? std::vector<int>{ 16, 32 } : std::vector<int>{ 32, 64, 128 };
+
+    std::vector<int> threadCounts = { 1 };
+    int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+    for (int t = 2; t < cores; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    if (cores > 1) {
+        threadCounts.push_back(cores);
+    }
+
+    // The settings of a freshly created Simplex resource with FBM enabled
+    SimplexGenerator generator = makeGenerator(SimplexGenerator::FRACTAL_FBM, 5, 0);
+
+    for (int threads : threadCounts) {
+        // parallelFor also runs chunks on the calling thread
+        SimplexJobPool pool((unsigned int)std::max(1, threads - 1));
+        auto parallel = [&pool, threads](int count, int grain, const std::function<void(int, int)> &body) {
+            if (threads == 1) {
+                body(0, count);
+            } else {
+                pool.parallelFor(count, SimplexJobPool::PRIORITY_INTERACTIVE, body, grain);
+            }
+        };
+
+        for (int size : sizes) {
+            std::vector<float> values((size_t)size * size);
+            std::vector<uint8_t> bytes(values.size());
+            int grain = std::max(1, 4096 / size);
+            std::string suffix = "/" + std::to_string(size) + "/t" + std::to_string(threads);
+
+            std::string name = "image/get_image" + suffix;
+            if (selected(options, name)) {
+                results.push_back(measure(options, "image", name, threads, (long long)values.size(), [&]() {
+                    parallel(size, grain, [&](int begin, int end) {
+                        generator.fillGrid2D(values.data(), size, size, false, begin, end);
+                    });
+                    SimplexPost::toL8(values.data(), bytes.data(), values.size(), true, false);
+                }));
+            }
+            name = "image/get_seamless_image" + suffix;
+            if (selected(options, name)) {
+                results.push_back(measure(options, "image", name, threads, (long long)values.size(), [&]() {
+                    parallel(size, grain, [&](int begin, int end) {
+                        generator.fillSeamless2D(values.data(), size, size, false, 0.1f, begin, end);
+                    });
+                    SimplexPost::toL8(values.data(), bytes.data(), values.size(), true, false);
+                }));
+            }
+        }
+
+        for (int size : volumeSizes) {
+            std::vector<float> values((size_t)size * size * size);
+            std::vector<uint8_t> bytes(values.size());
+            std::string name = "image/get_image_3d/" + std::to_string(size) + "/t" + std::to_string(threads);
+            if (selected(options, name)) {
+                results.push_back(measure(options, "image", name, threads, (long long)values.size(), [&]() {
+                    parallel(size, 1, [&](int begin, int end) {
+                        generator.fillGrid3D(values.data(), size, size, size, begin, end);
+                    });
+                    SimplexPost::toL8(values.data(), bytes.data(), values.size(), true, false);
+                }));
+            }
+        }
+    }
+}
+
+void writeJson(FILE *file, const std::vector<Result> &results) {
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"core_api_version\": %d,\n", SIMPLEX_CORE_API_VERSION);
+    std::fprintf(file, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        std::fprintf(file,
+            "    {\"name\": \"%s\", \"group\": \"%s\", \"threads\": %d, \"samples\": %lld, "
+            "\"ns_per_sample\": %.3f, \"ms_per_run\": %.4f}%s\n",
+            result.name.c_str(), result.group.c_str(), result.threads, result.samples,
+            result.nsPerSample, result.msPerRun, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            options.out = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--filter TEXT] [--out FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    runKernels(options, results);
+    runFractals(options, results);
+    runImages(options, results);
+
+    FILE *file = stdout;
+    if (!options.out.empty()) {
+        file = std::fopen(options.out.c_str(), "w");
+        if (file == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", options.out.c_str());
+            return 1;
+        }
+    }
+    writeJson(file, results);
+    if (file != stdout) {
+        std::fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,620 @@
+/**
+ * @file    simplex_verify.cpp
+ * @brief   Checks every optimised path of the noise core against the original scalar code.
+ *
+ * Build with `scons core_only=yes verify` and run `bin/simplex_verify [options]`:
+ *
+ *   --cases N        number of randomised parameter sets (default 24)
+ *   --seed N         seed of the parameter generator, to replay a failure
+ *   --ulp N          allowed distance in units in the last place (default 0)
+ *   --abs E          allowed absolute difference, checked when --ulp fails (default 0)
+ *
+ * The reference below is a port of the per-pixel loops the Simplex resource used before the
+ * core was split out, calling SimplexNoise directly. The one deliberate difference is get3D:
+ * the old get_noise_3d returned a constant through a comma operator, so the reference follows
+ * the corrected behaviour instead (domain warp and the single octave of FRACTAL_NONE, as in
+ * 2D) rather than reproducing the flat output. Each check prints the worst
+ * ULP / absolute error and the speedup of the optimised path; the exit code is 1 when any
+ * check is out of tolerance, so the tool can run headless in CI.
+ */
+
+#include "SimplexGenerator.h"
+#include "SimplexJobPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Tolerance {
+    int64_t ulp = 0;
+    double abs = 0.0;
+};
+
+/**
+ * The pre-split Simplex resource: noise parameters plus fractal and warp selection
+ */
+struct Reference {
+    SimplexNoise noise;
+    int type = 0;           // Simplex::FractalType
+    bool warpEnabled = false;
+    int warpType = 1;       // Simplex::DomainWarpFractalType
+
+    void applyWarp(float &x, float &y) const {
+        switch (warpType) {
+        case 2: noise.independent_domain_warp_fractal(x, y); break;
+        case 1: noise.progressive_domain_warp_fractal(x, y); break;
+        default: noise.single_domain_warp_gradient(noise.mDomainWarpAmplitude, x, y, x, y); break;
+        }
+    }
+
+    float get1D(float x) const {
+        return noise.fractal(x, type == 0);
+    }
+
+    float get2D(float x, float y) const {
+        if (warpEnabled)
+            applyWarp(x, y);
+        switch (type) {
+        case 2: return noise.ridged(x, y);
+        case 3: return noise.pingpong(x, y);
+        default: return noise.fractal(x, y, type == 0);
+        }
+    }
+
+    void applyWarp(float &x, float &y, float &z) const {
+        switch (warpType) {
+        case 2: noise.independent_domain_warp_fractal(x, y, z); break;
+        case 1: noise.progressive_domain_warp_fractal(x, y, z); break;
+        default: noise.single_domain_warp_gradient(noise.mDomainWarpAmplitude, x, y, z, x, y, z); break;
+        }
+    }
+
+    // Corrected 3D path, not the pre-split one (see the file comment)
+    float get3D(float x, float y, float z) const {
+        if (warpEnabled)
+            applyWarp(x, y, z);
+        switch (type) {
+        case 2: return noise.ridged(x, y, z);
+        case 3: return noise.pingpong(x, y, z);
+        default: return noise.fractal(x, y, z, type == 0);
+        }
+    }
+
+    void image(float *out, int w, int h, bool in3D) const {
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                out[y * w + x] = in3D ? get3D((float)x, 0.0f, (float)y) : get2D((float)x, (float)y);
+            }
+        }
+    }
+
+    void seamlessImage(float *out, int w, int h, bool in3D, float skirtIn) const {
+        float invW = 1.0f / (w - 1);
+        float invH = 1.0f / (h - 1);
+        float skirt = std::min(std::max(skirtIn, 0.0f), 0.5f);
+        for (int y = 0; y < h; y++) {
+            float ny = y * invH;
+            float vy = 1.0f;
+            if (ny < skirt) vy = ny / skirt;
+            else if (ny > 1.0f - skirt) vy = (1.0f - ny) / skirt;
+            for (int x = 0; x < w; x++) {
+                float nx = x * invW;
+                float vx = 1.0f;
+                if (nx < skirt) vx = nx / skirt;
+                else if (nx > 1.0f - skirt) vx = (1.0f - nx) / skirt;
+
+                float n;
+                if (in3D) {
+                    float ax = nx * 6.2831853071795864769252867666;
+                    float ay = ny * 6.2831853071795864769252867666;
+                    float px = std::cos(ax), pz = std::sin(ax), py = std::cos(ay), pw = std::sin(ay);
+                    n = get3D(px * 10.0f, py * 10.0f, pz * 10.0f) * 0.5f +
+                        get3D(py * 10.0f, pz * 10.0f, pw * 10.0f) * 0.5f;
+                } else {
+                    float c = get2D(nx, ny);
+                    float r = get2D(nx - 1.0f, ny);
+                    float b = get2D(nx, ny - 1.0f);
+                    float br = get2D(nx - 1.0f, ny - 1.0f);
+                    if (vx < 1.0f && vy < 1.0f) {
+                        n = SimplexNoise::Lerp(SimplexNoise::Lerp(br, b, vx), SimplexNoise::Lerp(r, c, vx), vy);
+                    } else if (vx < 1.0f) {
+                        n = SimplexNoise::Lerp(r, c, vx);
+                    } else if (vy < 1.0f) {
+                        n = SimplexNoise::Lerp(b, c, vy);
+                    } else {
+                        n = c;
+                    }
+                }
+                out[y * w + x] = n;
+            }
+        }
+    }
+
+    void image3D(float *out, int w, int h, int d) const {
+        for (int z = 0; z < d; z++)
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                    out[((size_t)z * h + y) * w + x] = get3D((float)x, (float)y, (float)z);
+    }
+
+    static float smoothstep(float from, float to, float s) {
+        // Godot's Math::smoothstep
+        float tolerance = std::max(0.00001f * std::fabs(from), 0.00001f);
+        if (from == to || std::fabs(from - to) < tolerance)
+            return from;
+        s = std::min(std::max((s - from) / (to - from), 0.0f), 1.0f);
+        return s * s * (3.0f - 2.0f * s);
+    }
+
+    static float edgeWeight(float n, float start, float end) {
+        if (n < start) return smoothstep(0.0f, start, n);
+        if (n > end) return 1.0f - smoothstep(end, 1.0f, n);
+        return 1.0f;
+    }
+
+    void seamlessImage3D(float *out, int w, int h, int d, float skirt) const {
+        float sx = 1.0f / (w - 1), sy = 1.0f / (h - 1), sz = 1.0f / (d - 1);
+        for (int z = 0; z < d; z++) {
+            float nz = z * sz;
+            for (int y = 0; y < h; y++) {
+                float ny = y * sy;
+                for (int x = 0; x < w; x++) {
+                    float nx = x * sx;
+                    float n000 = get3D(nx, ny, nz), n100 = get3D(nx - 1.0f, ny, nz);
+                    float n010 = get3D(nx, ny - 1.0f, nz), n110 = get3D(nx - 1.0f, ny - 1.0f, nz);
+                    float n001 = get3D(nx, ny, nz - 1.0f), n101 = get3D(nx - 1.0f, ny, nz - 1.0f);
+                    float n011 = get3D(nx, ny - 1.0f, nz - 1.0f), n111 = get3D(nx - 1.0f, ny - 1.0f, nz - 1.0f);
+                    float wx = edgeWeight(nx, skirt, 1.0f - skirt);
+                    float wy = edgeWeight(ny, skirt, 1.0f - skirt);
+                    float wz = edgeWeight(nz, skirt, 1.0f - skirt);
+                    float n0 = SimplexNoise::Lerp(SimplexNoise::Lerp(n000, n100, wx), SimplexNoise::Lerp(n010, n110, wx), wy);
+                    float n1 = SimplexNoise::Lerp(SimplexNoise::Lerp(n001, n101, wx), SimplexNoise::Lerp(n011, n111, wx), wy);
+                    out[((size_t)z * h + y) * w + x] = SimplexNoise::Lerp(n0, n1, wz);
+                }
+            }
+        }
+    }
+};
+
+SimplexGenerator toGenerator(const Reference &reference) {
+    SimplexGenerator generator;
+    generator.mNoise = reference.noise;
+    generator.mFractalType = (SimplexGenerator::FractalType)reference.type;
+    generator.mDomainWarpEnabled = reference.warpEnabled;
+    generator.mDomainWarpFractalType = (SimplexGenerator::DomainWarpFractalType)reference.warpType;
+    return generator;
+}
+
+Reference randomReference(std::mt19937 &rng) {
+    auto uniform = [&rng](float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(rng); };
+    auto integer = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+    Reference reference;
+    reference.noise.mSeed = integer(-100000, 100000);
+    reference.noise.mOctaves = (size_t)integer(1, 8);
+    reference.noise.mFrequency = uniform(0.001f, 0.2f);
+    reference.noise.mLacunarity = uniform(1.0f, 4.0f);
+    reference.noise.mPersistence = uniform(0.1f, 0.9f);
+    reference.noise.mPingPongStrength = uniform(0.5f, 4.0f);
+    reference.noise.mDomainWarpAmplitude = uniform(1.0f, 60.0f);
+    reference.noise.mDomainWarpFractalGain = uniform(0.1f, 0.9f);
+    reference.noise.mDomainWarpFractalLacunarity = uniform(1.0f, 8.0f);
+    reference.noise.mDomainWarpFractalOctaves = (size_t)integer(1, 6);
+    reference.noise.mDomainWarpFrequency = uniform(0.005f, 0.2f);
+    reference.type = integer(0, 3);
+    reference.warpEnabled = integer(0, 1) == 1;
+    reference.warpType = integer(0, 2);
+    return reference;
+}
+
+int64_t ulpDistance(float a, float b) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b) ? 0 : INT64_MAX;
+    }
+    int32_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(float));
+    std::memcpy(&ib, &b, sizeof(float));
+    // Map the sign-magnitude encoding onto a monotonic integer line
+    int64_t la = ia < 0 ? (int64_t)INT32_MIN - ia : ia;
+    int64_t lb = ib < 0 ? (int64_t)INT32_MIN - ib : ib;
+    return la > lb ? la - lb : lb - la;
+}
+
+double nowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class Verifier {
+public:
+    Verifier(Tolerance tolerance) : mTolerance(tolerance) {}
+
+    /**
+     * Run both paths once (timed), compare their outputs element by element and print a report line
+     */
+    void check(const std::string &name, size_t count,
+               const std::function<void(float *)> &reference, const std::function<void(float *)> &optimised) {
+        std::vector<float> expected(count), actual(count);
+        double start = nowMs();
+        reference(expected.data());
+        double referenceMs = nowMs() - start;
+        start = nowMs();
+        optimised(actual.data());
+        double optimisedMs = nowMs() - start;
+
+        int64_t worstUlp = 0;
+        double worstAbs = 0.0;
+        size_t failures = 0;
+        size_t firstFailure = 0;
+        for (size_t i = 0; i < count; i++) {
+            int64_t ulp = ulpDistance(expected[i], actual[i]);
+            double abs = std::fabs((double)expected[i] - (double)actual[i]);
+            worstUlp = std::max(worstUlp, ulp);
+            if (!std::isnan(abs))
+                worstAbs = std::max(worstAbs, abs);
+            if (ulp > mTolerance.ulp && !(abs <= mTolerance.abs)) {
+                if (failures++ == 0)
+                    firstFailure = i;
+            }
+        }
+
+        mChecks++;
+        double speedup = optimisedMs > 0.0 ? referenceMs / optimisedMs : 0.0;
+        std::printf("%-4s %-44s %9zu  max_ulp %-6lld max_abs %-10.3g ref %8.2f ms  opt %8.2f ms  x%.2f\n",
+                    failures ? "FAIL" : "ok", name.c_str(), count, (long long)worstUlp, worstAbs,
+                    referenceMs, optimisedMs, speedup);
+        if (failures) {
+            mFailures++;
+            std::printf("     %zu mismatches, first at index %zu: expected %.9g got %.9g\n",
+                        failures, firstFailure, expected[firstFailure], actual[firstFailure]);
+        }
+    }
+
+    int failures() const { return mFailures; }
+    int checks() const { return mChecks; }
+
+private:
+    Tolerance mTolerance;
+    int mChecks = 0;
+    int mFailures = 0;
+};
+
+void verifyCase(Verifier &verifier, const Reference &reference, SimplexJobPool &pool, std::mt19937 &rng, int index) {
+    const SimplexGenerator generator = toGenerator(reference);
+    const std::string prefix = "case " + std::to_string(index) + " ";
+
+    // Point samples over small, negative and very large coordinates
+    const size_t points = 4096;
+    std::vector<float> coords(points * 3);
+    const float ranges[] = { 16.0f, 1000.0f, 1.0e6f };
+    for (size_t i = 0; i < coords.size(); i++) {
+        float range = ranges[(i / 3) % 3];
+        coords[i] = std::uniform_real_distribution<float>(-range, range)(rng);
+    }
+
+    verifier.check(prefix + "sample 1d", points,
+        [&](float *out) { for (size_t i = 0; i < points; i++) out[i] = reference.get1D(coords[3 * i]); },
+        [&](float *out) { for (size_t i = 0; i < points; i++) out[i] = generator.sample(coords[3 * i]); });
+
+    std::vector<float> xy(points * 2);
+    for (size_t i = 0; i < points; i++) {
+        xy[2 * i] = coords[3 * i];
+        xy[2 * i + 1] = coords[3 * i + 1];
+    }
+    verifier.check(prefix + "sampleBatch2D", points,
+        [&](float *out) { for (size_t i = 0; i < points; i++) out[i] = reference.get2D(xy[2 * i], xy[2 * i + 1]); },
+        [&](float *out) { generator.sampleBatch2D(xy.data(), out, points); });
+    verifier.check(prefix + "sampleBatch3D", points,
+        [&](float *out) { for (size_t i = 0; i < points; i++) out[i] = reference.get3D(coords[3 * i], coords[3 * i + 1], coords[3 * i + 2]); },
+        [&](float *out) { generator.sampleBatch3D(coords.data(), out, points); });
+
+    // Whole images, serial and split across the pool
+    const int w = 96 + index % 5 * 13, h = 64 + index % 3 * 17;
+    const float skirt = std::uniform_real_distribution<float>(0.0f, 0.6f)(rng);
+    for (int in3D = 0; in3D <= 1; in3D++) {
+        std::string space = in3D ? " (3d space)" : "";
+        verifier.check(prefix + "fillGrid2D" + space, (size_t)w * h,
+            [&](float *out) { reference.image(out, w, h, in3D); },
+            [&](float *out) { generator.fillGrid2D(out, w, h, in3D, 0, h); });
+        verifier.check(prefix + "fillGrid2D parallel" + space, (size_t)w * h,
+            [&](float *out) { reference.image(out, w, h, in3D); },
+            [&](float *out) {
+                pool.parallelFor(h, SimplexJobPool::PRIORITY_INTERACTIVE,
+                    [&](int begin, int end) { generator.fillGrid2D(out, w, h, in3D, begin, end); }, 3);
+            });
+        verifier.check(prefix + "fillSeamless2D parallel" + space, (size_t)w * h,
+            [&](float *out) { reference.seamlessImage(out, w, h, in3D, skirt); },
+            [&](float *out) {
+                pool.parallelFor(h, SimplexJobPool::PRIORITY_INTERACTIVE,
+                    [&](int begin, int end) { generator.fillSeamless2D(out, w, h, in3D, skirt, begin, end); }, 3);
+            });
+        // Tiles (with ragged right/bottom edges) copied back into the full image
+        for (int seamless = 0; seamless <= 1; seamless++) {
+            verifier.check(prefix + "fillTile2D" + (seamless ? " seamless" : "") + space, (size_t)w * h,
+                [&](float *out) {
+                    if (seamless) reference.seamlessImage(out, w, h, in3D, skirt);
+                    else reference.image(out, w, h, in3D);
+                },
+                [&](float *out) {
+                    const int tile = 40;
+                    std::vector<float> buffer((size_t)tile * tile);
+                    for (int y0 = 0; y0 < h; y0 += tile) {
+                        for (int x0 = 0; x0 < w; x0 += tile) {
+                            int tw = std::min(tile, w - x0), th = std::min(tile, h - y0);
+                            generator.fillTile2D(buffer.data(), w, h, seamless, in3D, skirt, x0, y0, tw, th);
+                            for (int y = 0; y < th; y++)
+                                std::copy(&buffer[(size_t)y * tw], &buffer[(size_t)y * tw] + tw, out + (size_t)(y0 + y) * w + x0);
+                        }
+                    }
+                });
+        }
+    }
+
+    // Output shaping through a baked curve, applied after the sample (and after seamless blending)
+    std::vector<float> curve(64);
+    for (size_t i = 0; i < curve.size(); i++) {
+        curve[i] = std::uniform_real_distribution<float>(0.0f, 1.0f)(rng);
+    }
+    SimplexGenerator shaped = generator;
+    shaped.mRemapCurve = std::make_shared<const SimplexCurveTable>(curve);
+    verifier.check(prefix + "fillSeamless2D remap curve", (size_t)w * h,
+        [&](float *out) {
+            reference.seamlessImage(out, w, h, false, skirt);
+            for (size_t i = 0; i < (size_t)w * h; i++) {
+                float x = std::min(std::max((out[i] + 1.0f) * 0.5f, 0.0f), 1.0f);
+                if (x >= 1.0f) {
+                    out[i] = curve.back() * 2.0f - 1.0f; // the last sample, not an interpolation towards it
+                    continue;
+                }
+                float t = x * (curve.size() - 1);
+                size_t index = (size_t)t;
+                out[i] = (curve[index] + (t - index) * (curve[index + 1] - curve[index])) * 2.0f - 1.0f;
+            }
+        },
+        [&](float *out) { shaped.fillSeamless2D(out, w, h, false, skirt, 0, h); });
+
+    // A texture curve applied in post-processing shapes the same value as the noise curve,
+    // before normalize/invert, so both orders of a pipeline give the same heights
+    {
+        const bool normalize = rng() & 1, invert = rng() & 1;
+        const SimplexCurveTable table(curve);
+        std::vector<float> field((size_t)w * h);
+        generator.fillSeamless2D(field.data(), w, h, false, skirt, 0, h);
+        verifier.check(prefix + "toHeights remap curve order", (size_t)w * h,
+            [&](float *out) {
+                std::vector<float> values((size_t)w * h);
+                shaped.fillSeamless2D(values.data(), w, h, false, skirt, 0, h);
+                SimplexPost::toHeights(values.data(), out, values.size(), normalize, invert);
+            },
+            [&](float *out) { SimplexPost::toHeights(field.data(), out, field.size(), normalize, invert, &table); });
+    }
+
+    const float originX = std::uniform_real_distribution<float>(-5.0e4f, 5.0e4f)(rng);
+    const float originY = std::uniform_real_distribution<float>(-5.0e4f, 5.0e4f)(rng);
+    const float step = std::uniform_real_distribution<float>(0.1f, 4.0f)(rng);
+    verifier.check(prefix + "fillRegion2D", (size_t)w * h,
+        [&](float *out) {
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                    out[y * w + x] = reference.get2D(originX + x * step, originY + y * step);
+        },
+        [&](float *out) { generator.fillRegion2D(out, w, h, originX, originY, step, step, 0, h); });
+
+    // Progressive passes at strides 8, 4, 2, 1 sample every pixel once and end on the full image
+    for (int seamless = 0; seamless <= 1; seamless++) {
+        verifier.check(prefix + "fillStrided2D progressive" + (seamless ? " seamless" : ""), (size_t)w * h,
+            [&](float *out) {
+                if (seamless) reference.seamlessImage(out, w, h, false, skirt);
+                else reference.image(out, w, h, false);
+            },
+            [&](float *out) {
+                for (int stride = 8; stride >= 1; stride /= 2) {
+                    int rows = (h + stride - 1) / stride;
+                    pool.parallelFor(rows, SimplexJobPool::PRIORITY_INTERACTIVE, [&](int begin, int end) {
+                        generator.fillStrided2D(out, w, h, seamless, false, skirt, stride, stride != 8, begin, end);
+                    });
+                }
+            });
+    }
+
+    // Scrolling: a wrapped window at one offset, moved by filling only the exposed strips
+    for (int in3D = 0; in3D <= 1; in3D++) {
+        std::uniform_int_distribution<int> shift(-w - 8, w + 8);
+        const int fromX = shift(rng), fromY = shift(rng);
+        const int toX = fromX + shift(rng) / 3, toY = fromY + shift(rng) / 3;
+        verifier.check(prefix + "fillWrapped2D scrolled" + (in3D ? " 3D space" : ""), (size_t)w * h,
+            [&](float *out) {
+                for (int y = toY; y < toY + h; y++)
+                    for (int x = toX; x < toX + w; x++)
+                        out[(size_t)(((y % h) + h) % h) * w + ((x % w) + w) % w] =
+                            in3D ? reference.get3D((float)x, 0.0f, (float)y) : reference.get2D((float)x, (float)y);
+            },
+            [&](float *out) {
+                generator.fillWrapped2D(out, w, h, in3D, fromX, fromY, fromX + w, fromY + h);
+                SimplexRect rects[2];
+                int count = SimplexGenerator::scrollExposed(w, h, fromX, fromY, toX, toY, rects);
+                for (int i = 0; i < count; i++)
+                    generator.fillWrapped2D(out, w, h, in3D, rects[i].x0, rects[i].y0, rects[i].x1, rects[i].y1);
+            });
+    }
+    // A clipmap level: the same scroll on the grid of every fourth sample
+    {
+        const int spacing = 4;
+        std::uniform_int_distribution<int> shift(-w - 8, w + 8);
+        const int fromX = shift(rng), fromY = shift(rng);
+        const int toX = fromX + shift(rng) / 3, toY = fromY + shift(rng) / 3;
+        verifier.check(prefix + "fillWrapped2D scrolled spacing", (size_t)w * h,
+            [&](float *out) {
+                for (int y = toY; y < toY + h; y++)
+                    for (int x = toX; x < toX + w; x++)
+                        out[(size_t)(((y % h) + h) % h) * w + ((x % w) + w) % w] =
+                            reference.get2D((float)(x * spacing), (float)(y * spacing));
+            },
+            [&](float *out) {
+                generator.fillWrapped2D(out, w, h, false, fromX, fromY, fromX + w, fromY + h, spacing);
+                SimplexRect rects[2];
+                int count = SimplexGenerator::scrollExposed(w, h, fromX, fromY, toX, toY, rects);
+                for (int i = 0; i < count; i++)
+                    generator.fillWrapped2D(out, w, h, false, rects[i].x0, rects[i].y0, rects[i].x1, rects[i].y1, spacing);
+            });
+    }
+
+    const int d = 12 + index % 4;
+    verifier.check(prefix + "fillGrid3D parallel", (size_t)w * h * d,
+        [&](float *out) { reference.image3D(out, w, h, d); },
+        [&](float *out) {
+            pool.parallelFor(d, SimplexJobPool::PRIORITY_INTERACTIVE,
+                [&](int begin, int end) { generator.fillGrid3D(out, w, h, d, begin, end); });
+        });
+    verifier.check(prefix + "fillSeamless3D parallel", (size_t)w * h * d,
+        [&](float *out) { reference.seamlessImage3D(out, w, h, d, skirt); },
+        [&](float *out) {
+            pool.parallelFor(d, SimplexJobPool::PRIORITY_INTERACTIVE,
+                [&](int begin, int end) { generator.fillSeamless3D(out, w, h, d, skirt, begin, end); });
+        });
+    // Streaming fill through a three-slice buffer, copied out batch by batch
+    verifier.check(prefix + "fillSlices3D streamed seamless", (size_t)w * h * d,
+        [&](float *out) { reference.seamlessImage3D(out, w, h, d, skirt); },
+        [&](float *out) {
+            const int batch = 3;
+            std::vector<float> buffer((size_t)w * h * batch);
+            for (int first = 0; first < d; first += batch) {
+                int last = std::min(first + batch, d);
+                generator.fillSlices3D(buffer.data(), w, h, d, true, skirt, first, last);
+                std::copy(buffer.begin(), buffer.begin() + (size_t)w * h * (last - first), out + (size_t)w * h * first);
+            }
+        });
+
+    // Quantization to the L8 bytes stored in the images, compared as floats
+    std::vector<float> field((size_t)w * h);
+    generator.fillGrid2D(field.data(), w, h, false, 0, h);
+    for (int mode = 0; mode < 4; mode++) {
+        bool normalize = (mode & 1) != 0, invert = (mode & 2) != 0;
+        verifier.check(prefix + "toL8 n" + std::to_string(normalize) + " i" + std::to_string(invert), field.size(),
+            [&](float *out) {
+                for (size_t i = 0; i < field.size(); i++) {
+                    float n = field[i];
+                    if (normalize) n = (n + 1.0f) * 0.5f;
+                    if (invert) n = 1.0f - n;
+                    n = std::min(std::max(n, 0.0f), 1.0f);
+                    out[i] = (float)static_cast<uint8_t>(n * 255.0f);
+                }
+            },
+            [&](float *out) {
+                std::vector<uint8_t> bytes(field.size());
+                SimplexPost::toL8(field.data(), bytes.data(), field.size(), normalize, invert);
+                for (size_t i = 0; i < bytes.size(); i++) out[i] = bytes[i];
+            });
+    }
+
+    // Half float heights (FORMAT_RH), compared as the raw binary16 bits
+    verifier.check(prefix + "toHalfHeights", field.size(),
+        [&](float *out) {
+            for (size_t i = 0; i < field.size(); i++) {
+                double n = std::min(std::max((field[i] + 1.0f) * 0.5f, 0.0f), 1.0f);
+                int exponent = n > 0.0 ? std::ilogb(n) : -15;
+                double bits;
+                if (exponent < -14) {
+                    bits = std::nearbyint(std::ldexp(n, 24));
+                } else {
+                    bits = (exponent + 15) * 1024.0 + std::nearbyint((std::ldexp(n, -exponent) - 1.0) * 1024.0);
+                }
+                out[i] = (float)bits;
+            }
+        },
+        [&](float *out) {
+            std::vector<uint16_t> halves(field.size());
+            SimplexPost::toHalfHeights(field.data(), halves.data(), field.size(), true, false);
+            for (size_t i = 0; i < halves.size(); i++) out[i] = halves[i];
+        });
+
+    // Color ramp lookup: each RGBA8 pixel is the table entry of its L8 value
+    std::vector<uint8_t> lut(256 * 4);
+    for (uint8_t &entry : lut) {
+        entry = (uint8_t)std::uniform_int_distribution<int>(0, 255)(rng);
+    }
+    verifier.check(prefix + "toRGBA8", field.size() * 4,
+        [&](float *out) {
+            for (size_t i = 0; i < field.size(); i++) {
+                float n = std::min(std::max((field[i] + 1.0f) * 0.5f, 0.0f), 1.0f);
+                uint8_t value = static_cast<uint8_t>(n * 255.0f);
+                for (int c = 0; c < 4; c++) out[4 * i + c] = lut[4 * value + c];
+            }
+        },
+        [&](float *out) {
+            std::vector<uint8_t> bytes(field.size() * 4);
+            SimplexPost::toRGBA8(field.data(), bytes.data(), field.size(), true, false, lut.data());
+            for (size_t i = 0; i < bytes.size(); i++) out[i] = bytes[i];
+        });
+
+    // Normals of a scrolled (wrapped) field are those of the same view unwrapped, moved with it
+    {
+        std::vector<float> heights(field.size()), wrapped(field.size());
+        SimplexPost::toHeights(field.data(), heights.data(), field.size(), true, false);
+        const int seamX = std::uniform_int_distribution<int>(0, w - 1)(rng);
+        const int seamY = std::uniform_int_distribution<int>(0, h - 1)(rng);
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++)
+                wrapped[(size_t)((y + seamY) % h) * w + (x + seamX) % w] = heights[(size_t)y * w + x];
+        const float strength = std::uniform_real_distribution<float>(1.0f, 16.0f)(rng);
+        verifier.check(prefix + "toNormalsWrapped", field.size() * 4,
+            [&](float *out) {
+                std::vector<uint8_t> bytes(field.size() * 4);
+                SimplexPost::toNormals(heights.data(), bytes.data(), w, h, strength, false, SimplexPost::NORMAL_RGBA8, 0, h);
+                for (int y = 0; y < h; y++)
+                    for (int x = 0; x < w; x++)
+                        for (int c = 0; c < 4; c++)
+                            out[4 * ((size_t)((y + seamY) % h) * w + (x + seamX) % w) + c] = bytes[4 * ((size_t)y * w + x) + c];
+            },
+            [&](float *out) {
+                std::vector<uint8_t> bytes(field.size() * 4);
+                SimplexPost::toNormalsWrapped(wrapped.data(), bytes.data(), w, h, strength, seamX, seamY,
+                    SimplexPost::NORMAL_RGBA8, 0, h);
+                for (size_t i = 0; i < bytes.size(); i++) out[i] = bytes[i];
+            });
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    int cases = 24;
+    unsigned int seed = 20240601u;
+    Tolerance tolerance;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--cases") == 0 && i + 1 < argc) {
+            cases = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--ulp") == 0 && i + 1 < argc) {
+            tolerance.ulp = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--abs") == 0 && i + 1 < argc) {
+            tolerance.abs = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--cases N] [--seed N] [--ulp N] [--abs E]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("simplex_verify: core API %d, seed %u, %d cases, tolerance %lld ulp / %g abs\n",
+                SIMPLEX_CORE_API_VERSION, seed, cases, (long long)tolerance.ulp, tolerance.abs);
+
+    std::mt19937 rng(seed);
+    SimplexJobPool pool;
+    Verifier verifier(tolerance);
+    for (int i = 0; i < cases; i++) {
+        Reference reference = randomReference(rng);
+        verifyCase(verifier, reference, pool, rng, i);
+    }
+
+    std::printf("%d of %d checks failed\n", verifier.failures(), verifier.checks());
+    return verifier.failures() == 0 ? 0 : 1;
+}